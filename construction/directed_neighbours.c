@@ -0,0 +1,292 @@
+/*
+ *
+ * Copyright (C) 2026 Ghent University.
+ */
+
+/* This program reads directed graphs in watercluster or digraph6 format from
+ * standard in and checks for each graph which of the graphs that are obtained
+ * by removing, flipping or adding a single arc are hypohamiltonian.
+ *
+ *
+ * Compile with:
+ *
+ *     cc -o directed_neighbours -O4 directed_neighbours.c
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+
+#include "../shared/directed_base.h"
+#include "../shared/directed_io.h"
+#include "../shared/directed_stats.h"
+#include "../shared/directed_hamiltonian.h"
+
+#define MODIFY_REMOVE 1
+#define MODIFY_FLIP 2
+#define MODIFY_ADD 4
+
+unsigned long long int graph_count = 0;
+unsigned long long int neighbour_count = 0;
+unsigned long long int hypohamiltonian_count = 0;
+unsigned long long int filtered_count = 0;
+
+int modifications = 0;
+boolean full_check = FALSE;
+boolean do_filtering = FALSE;
+boolean invert = FALSE;
+
+void (*write_graph)(GRAPH, DEGREES, FILE *) = write_watercluster_format;
+
+//================ NEIGHBOURS ===================
+
+/**
+ * Checks the modified graph and writes or reports it. The witnesses of the
+ * original graph are in neighbour before the modification, so only the
+ * searches that the modification invalidated are repeated.
+ */
+void check_neighbour(WITNESSED_GRAPH *neighbour, const char *modification, int from, int to){
+    boolean value;
+
+    neighbour_count++;
+
+    start_phase(PHASE_SEARCH);
+    if(full_check){
+        value = is_hypohamiltonian(neighbour->graph, neighbour->out, neighbour->in);
+    } else {
+        value = witnessed_is_hypohamiltonian(neighbour);
+    }
+    stop_phase(PHASE_SEARCH);
+
+    if(value){
+        hypohamiltonian_count++;
+    }
+
+    if(do_filtering){
+        if((invert && !value) || (!invert && value)){
+            filtered_count++;
+            start_phase(PHASE_ENCODE);
+            write_graph(neighbour->graph, neighbour->out, stdout);
+            stop_phase(PHASE_ENCODE);
+        }
+    } else if(value){
+        fprintf(stdout, "Graph %llu: %s %d->%d gives a hypohamiltonian graph.\n",
+                input_graph_number(), modification, from, to);
+    }
+}
+
+void check_neighbours(GRAPH graph, DEGREES out, DEGREES in){
+    WITNESSED_GRAPH original, neighbour;
+    int v, w, i;
+    int order = graph[0][0];
+
+    prepare_witnessed_graph(&original, graph, out, in);
+    if(!full_check){
+        start_phase(PHASE_SEARCH);
+        witnessed_is_hypohamiltonian(&original);
+        stop_phase(PHASE_SEARCH);
+    }
+
+    for(v = 1; v <= order; v++){
+        for(i = 0; i < out[v]; i++){
+            w = graph[v][i];
+            if(modifications & MODIFY_REMOVE){
+                neighbour = original;
+                witnessed_remove_arc(&neighbour, v, w);
+                check_neighbour(&neighbour, "removing", v, w);
+            }
+            //flipping an arc of a 2-cycle would give a double arc
+            if((modifications & MODIFY_FLIP) && !has_arc(graph, out, w, v) && out[w] < MAXVAL){
+                neighbour = original;
+                witnessed_flip_arc(&neighbour, v, w);
+                check_neighbour(&neighbour, "flipping", v, w);
+            }
+        }
+    }
+
+    if(modifications & MODIFY_ADD){
+        for(v = 1; v <= order; v++){
+            if(out[v] == MAXVAL) continue;
+            for(w = 1; w <= order; w++){
+                if(w != v && !has_arc(graph, out, v, w)){
+                    neighbour = original;
+                    witnessed_add_arc(&neighbour, v, w);
+                    check_neighbour(&neighbour, "adding", v, w);
+                }
+            }
+        }
+    }
+}
+
+//====================== USAGE =======================
+
+void help(char *name) {
+    fprintf(stderr, "Checks all graphs that differ in a single arc from the input graphs for\n");
+    fprintf(stderr, "being hypohamiltonian.\n\n");
+    fprintf(stderr, "Usage\n=====\n");
+    fprintf(stderr, " %s [options]\n\n", name);
+    fprintf(stderr, "For each input graph the cycles that are found in the graph and in its\n");
+    fprintf(stderr, "vertex-deleted subgraphs are kept, and for each modification only the\n");
+    fprintf(stderr, "subgraphs in which these are no longer valid are searched again. The\n");
+    fprintf(stderr, "modified graphs are not checked for isomorphism.\n");
+    fprintf(stderr, "\nThis program can handle graphs up to %d vertices. Recompile with a larger\n", MAXN);
+    fprintf(stderr, "value for MAXN if you need to handle larger graphs.\n\n");
+    fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -r, --remove\n");
+    fprintf(stderr, "       Remove a single arc.\n");
+    fprintf(stderr, "    -F, --flip\n");
+    fprintf(stderr, "       Flip a single arc. Arcs in a 2-cycle are not flipped.\n");
+    fprintf(stderr, "    -a, --add\n");
+    fprintf(stderr, "       Add a single arc.\n");
+    fprintf(stderr, "       If none of these options is given, all three modifications are used.\n");
+    fprintf(stderr, "    -f, --filter\n");
+    fprintf(stderr, "       Write the modified graphs that are hypohamiltonian.\n");
+    fprintf(stderr, "    -i, --invert\n");
+    fprintf(stderr, "       Invert the filter.\n");
+    fprintf(stderr, "    --full\n");
+    fprintf(stderr, "       Check each modified graph from scratch (for comparison).\n");
+    fprintf(stderr, "    -u n, --update n\n");
+    fprintf(stderr, "       Give an update every n graphs.\n");
+    fprintf(stderr, "    -D, --digraph6\n");
+    fprintf(stderr, "       Reads graphs in digraph6 format instead of watercluster format.\n");
+    fprintf(stderr, "    -O format, --output-format format\n");
+    fprintf(stderr, "       Writes graphs in the given format: wcf (watercluster, default), d6\n");
+    fprintf(stderr, "       (digraph6), bits (bitset container), adj (adjacency lists) or multi\n");
+    fprintf(stderr, "       (multi_code).\n");
+    help_shared_io_options(stderr);
+    fprintf(stderr, "    -h, --help\n");
+    fprintf(stderr, "       Print this help and return.\n");
+}
+
+void usage(char *name) {
+    fprintf(stderr, "Usage: %s [options]\n", name);
+    fprintf(stderr, "For more information type: %s -h \n\n", name);
+}
+
+/*
+ *
+ */
+int main(int argc, char** argv) {
+
+    GRAPH graph;
+    DEGREES out;
+    DEGREES in;
+
+    boolean (*read_graph)(FILE *, GRAPH, DEGREES, DEGREES) = read_graph_from_watercluster_file;
+
+    int update = 0;
+
+
+    /*=========== commandline parsing ===========*/
+
+    int c;
+    char *name = argv[0];
+    static struct option long_options[] = {
+        {"full", no_argument, NULL, 0},
+        {"remove", no_argument, NULL, 'r'},
+        {"flip", no_argument, NULL, 'F'},
+        {"add", no_argument, NULL, 'a'},
+        {"update", required_argument, NULL, 'u'},
+        {"invert", no_argument, NULL, 'i'},
+        {"filter", no_argument, NULL, 'f'},
+        {"digraph6", no_argument, NULL, 'D'},
+        {"output-format", required_argument, NULL, 'O'},
+        {"help", no_argument, NULL, 'h'},
+        SHARED_IO_OPTIONS,
+        {NULL, 0, NULL, 0}
+    };
+    int option_index = 0;
+
+    while ((c = getopt_long(argc, argv, "hrFafiu:DO:", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 0:
+                switch(option_index) {
+                    case 0:
+                        full_check = TRUE;
+                        break;
+                    default:
+                        fprintf(stderr, "Illegal option index %d.\n", option_index);
+                        usage(name);
+                        return EXIT_FAILURE;
+                }
+                break;
+            case 'r':
+                modifications |= MODIFY_REMOVE;
+                break;
+            case 'F':
+                modifications |= MODIFY_FLIP;
+                break;
+            case 'a':
+                modifications |= MODIFY_ADD;
+                break;
+            case 'u':
+                update = atoi(optarg);
+                break;
+            case 'i':
+                invert = TRUE;
+                break;
+            case 'f':
+                do_filtering = TRUE;
+                break;
+            case 'D':
+                read_graph = read_graph_from_digraph6_file;
+                break;
+            case 'O':
+                write_graph = graph_writer_for_format(optarg);
+                if(write_graph == NULL){
+                    fprintf(stderr, "Unknown output format: %s -- exiting!\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case SELECT_RANGE_OPTION:
+            case SELECT_IDS_OPTION:
+            case SELECT_INDEX_OPTION:
+            case COMPRESS_OPTION:
+            case COMPRESS_THREADS_OPTION:
+                handle_shared_io_option(c, optarg);
+                break;
+            case 'h':
+                help(name);
+                return EXIT_SUCCESS;
+            case '?':
+                usage(name);
+                return EXIT_FAILURE;
+            default:
+                fprintf(stderr, "Illegal option %c.\n", c);
+                usage(name);
+                return EXIT_FAILURE;
+        }
+    }
+    if(!modifications){
+        modifications = MODIFY_REMOVE | MODIFY_FLIP | MODIFY_ADD;
+    }
+    if(!do_filtering && update){
+        fprintf(stderr, "Updates are only available when filtering is enabled.\n");
+        update = 0;
+    }
+
+    start_phase(PHASE_DECODE);
+    while (read_graph(stdin, graph, out, in)) {
+        stop_phase(PHASE_DECODE);
+        graph_count++;
+
+        check_neighbours(graph, out, in);
+        if(update && !(graph_count % update)){
+            fprintf(stderr, "Read: %llu. Neighbours: %llu. Filtered: %llu\n",
+                    graph_count, neighbour_count, filtered_count);
+        }
+        start_phase(PHASE_DECODE);
+    }
+    stop_phase(PHASE_DECODE);
+
+    fprintf(stderr, "Read %llu graph%s.\n", graph_count, graph_count==1 ? "" : "s");
+    fprintf(stderr, "Checked %llu neighbour%s.\n", neighbour_count, neighbour_count==1 ? "" : "s");
+    fprintf(stderr, "Hypohamiltonian: %llu\n", hypohamiltonian_count);
+    if(do_filtering){
+        fprintf(stderr, "Filtered %llu graph%s.\n", filtered_count, filtered_count==1 ? "" : "s");
+    }
+
+    return (EXIT_SUCCESS);
+}
@@ -20,6 +20,7 @@
 
 #include "../shared/directed_base.h"
 #include "../shared/directed_io.h"
+#include "../shared/directed_stats.h"
 
 void flip_all_arcs(GRAPH graph, DEGREES out, DEGREES in, GRAPH graph_result, DEGREES out_result, DEGREES in_result){
     int i, j;
@@ -46,6 +47,11 @@ void help(char *name) {
     fprintf(stderr, "Valid options\n=============\n");
     fprintf(stderr, "    -D, --digraph6\n");
     fprintf(stderr, "       Reads graphs in digraph6 format instead of watercluster format.\n");
+    fprintf(stderr, "    -O format, --output-format format\n");
+    fprintf(stderr, "       Writes graphs in the given format: wcf (watercluster, default), d6\n");
+    fprintf(stderr, "       (digraph6), bits (bitset container), adj (adjacency lists) or multi\n");
+    fprintf(stderr, "       (multi_code).\n");
+    help_shared_io_options(stderr);
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
@@ -61,6 +67,7 @@ void usage(char *name) {
 int main(int argc, char** argv) {
     
     boolean (*read_graph)(FILE *, GRAPH, DEGREES, DEGREES) = read_graph_from_watercluster_file;
+    void (*write_graph)(GRAPH, DEGREES, FILE *) = write_watercluster_format;
     void (*transform_graph)(GRAPH, DEGREES, DEGREES, GRAPH, DEGREES, DEGREES) = NULL;
     
 
@@ -73,7 +80,7 @@ int main(int argc, char** argv) {
         exit(EXIT_FAILURE);
     }
     char *transformation = argv[1];
-    if(strcmp(transformation, "flip")){
+    if(strcmp(transformation, "flip")==0){
         transform_graph = flip_all_arcs;
     } else {
         fprintf(stderr, "Unknown transformation: %s -- exiting!\n", transformation);
@@ -81,15 +88,33 @@ int main(int argc, char** argv) {
     }
     static struct option long_options[] = {
         {"digraph6", no_argument, NULL, 'D'},
-        {"help", no_argument, NULL, 'h'}
+        {"output-format", required_argument, NULL, 'O'},
+        {"help", no_argument, NULL, 'h'},
+        SHARED_IO_OPTIONS,
+        {NULL, 0, NULL, 0}
     };
     int option_index = 0;
 
-    while ((c = getopt_long(argc, argv, "hD", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "hDO:", long_options, &option_index)) != -1) {
         switch (c) {
             case 'D':
                 read_graph = read_graph_from_digraph6_file;
                 break;
+            case 'O':
+                write_graph = graph_writer_for_format(optarg);
+                if(write_graph == NULL){
+                    fprintf(stderr, "Unknown output format: %s -- exiting!\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case SELECT_RANGE_OPTION:
+            case SELECT_IDS_OPTION:
+            case SELECT_INDEX_OPTION:
+            case COMPRESS_OPTION:
+            case COMPRESS_THREADS_OPTION:
+                handle_shared_io_option(c, optarg);
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -106,11 +131,19 @@ int main(int argc, char** argv) {
     GRAPH graph;        DEGREES out;        DEGREES in;
     GRAPH graph_result; DEGREES out_result; DEGREES in_result;
 
+    start_phase(PHASE_DECODE);
     while(read_graph(stdin, graph, out, in)){
+        stop_phase(PHASE_DECODE);
+        start_phase(PHASE_SEARCH);
         transform_graph(graph, out, in, graph_result, out_result, in_result);
+        stop_phase(PHASE_SEARCH);
     
-        write_watercluster_format(graph_result, out_result, stdout);
+        start_phase(PHASE_ENCODE);
+        write_graph(graph_result, out_result, stdout);
+        stop_phase(PHASE_ENCODE);
+        start_phase(PHASE_DECODE);
     }
+    stop_phase(PHASE_DECODE);
     
     return (EXIT_SUCCESS);
 }
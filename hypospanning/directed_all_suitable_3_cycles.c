@@ -19,126 +19,18 @@
 
 #include "../shared/directed_base.h"
 #include "../shared/directed_io.h"
+#include "../shared/directed_stats.h"
+#include "../shared/directed_hamiltonian.h"
 
 unsigned long long int graph_count = 0;
 unsigned long long int filtered_count = 0;
 
 boolean graph_number_header = TRUE;
 
-//================ HYPOHAMILTONIAN ===================
+//================ SUITABLE 3-CYCLES ===================
 
-boolean current_cycle[MAXN+1];
-
-/**
-  * 
-  */
-boolean continue_cycle(GRAPH graph, DEGREES out, int last, int remaining, int first) {
-    int i;
-    
-    if(remaining==0){
-        //TODO: use bitsets (although it appears this does not give a significant gain)
-        for(i = 0; i < out[last]; i++){
-            if(graph[last][i]==first){
-                return TRUE;
-            }
-        }
-        return FALSE;
-    }
-    
-    for(i = 0; i < out[last]; i++){
-        if(!current_cycle[graph[last][i]]){
-            current_cycle[graph[last][i]]=TRUE;
-            if(continue_cycle(graph, out, graph[last][i], remaining - 1, first)){
-                return TRUE;
-            }
-            current_cycle[graph[last][i]]=FALSE;
-        }
-    }
-    
-    return FALSE;
-}
-
-boolean start_cycle_through_edge(GRAPH graph, DEGREES out, int v1, int v2, int order){
-    int i;
-    //mark the start vertices as being in the cycle
-    current_cycle[v1] = TRUE;
-    current_cycle[v2] = TRUE;
-    for(i = 0; i < out[v2]; i++){
-        if(!current_cycle[graph[v2][i]]){
-            current_cycle[graph[v2][i]]=TRUE;
-            //search for cycle containing the edge (v, graph[v][i])
-            if(continue_cycle(graph, out, graph[v2][i], order - 3, v1)){
-                return TRUE;
-            }
-            current_cycle[graph[v2][i]]=FALSE;
-        }
-    }
-    current_cycle[v2] = FALSE;
-    current_cycle[v1] = FALSE;
-    
-    return FALSE;
-}
-
-//directed 3-cycle is x -> y -> z -> x
-boolean is_suitable_3_cycle(GRAPH graph, DEGREES out, DEGREES in, int x, int y, int z){
-    int v, i;
-    for(v = 1; v <= graph[0][0]; v++){
-        //clear possible previous path
-        for(i=0; i<=MAXN; i++){
-            current_cycle[i] = FALSE;
-        }
-        //mark v as being removed
-        current_cycle[v] = TRUE;
-        
-        //check for hamiltonian cycle through an edge of the 3-cycle
-        if(v == x){
-            if(!start_cycle_through_edge(graph, out, y, z, graph[0][0]-1)){
-                return FALSE;
-            }
-        } else if(v == y){
-            if(!start_cycle_through_edge(graph, out, z, x, graph[0][0]-1)){
-                return FALSE;
-            }
-        } else if(v == z){
-            if(!start_cycle_through_edge(graph, out, x, y, graph[0][0]-1)){
-                return FALSE;
-            }
-        } else {
-            if(!start_cycle_through_edge(graph, out, x, y, graph[0][0]-1) &&
-                    !start_cycle_through_edge(graph, out, y, z, graph[0][0]-1) &&
-                    !start_cycle_through_edge(graph, out, z, x, graph[0][0]-1)){
-                return FALSE;
-            }
-        }
-    }
-    return TRUE;
-}
-
-void find_suitable_3_cycles(GRAPH graph, DEGREES out, DEGREES in){
-    int x, i, j;
-    
-    int order = graph[0][0];
-    
-    //check all 3-cycles
-    for(x = 1; x <= order; x++){
-        for(i = 0; i < out[x]; i++){
-            int y = graph[x][i];
-            if(y < x) continue;
-            for(j = 0; j < out[y]; j++){
-                int z = graph[y][j];
-                if(z>x){
-                    int k = 0;
-                    while(k < out[z] && graph[z][k]!=x) k++;
-                    if(k < out[z]){
-                        //found a 3-cycle
-                        if(is_suitable_3_cycle(graph, out, in, x, y, z)){
-                            fprintf(stdout, "%d, %d, %d\n", x, y, z);
-                        }
-                    }
-                }
-            }
-        }
-    }
+void print_suitable_3_cycle(int x, int y, int z, void *data){
+    fprintf(stdout, "%d, %d, %d\n", x, y, z);
 }
 
 //====================== USAGE =======================
@@ -152,6 +44,7 @@ void help(char *name) {
     fprintf(stderr, "Valid options\n=============\n");
     fprintf(stderr, "    --no-header\n");
     fprintf(stderr, "       Do not print a header per graph.\n");
+    help_shared_io_options(stderr);
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
@@ -185,7 +78,9 @@ int main(int argc, char** argv) {
     static struct option long_options[] = {
         {"no-header", no_argument, NULL, 0},
         {"digraph6", no_argument, NULL, 'D'},
-        {"help", no_argument, NULL, 'h'}
+        {"help", no_argument, NULL, 'h'},
+        SHARED_IO_OPTIONS,
+        {NULL, 0, NULL, 0}
     };
     int option_index = 0;
 
@@ -214,6 +109,13 @@ int main(int argc, char** argv) {
             case 'D':
                 read_graph = read_graph_from_digraph6_file;
                 break;
+            case SELECT_RANGE_OPTION:
+            case SELECT_IDS_OPTION:
+            case SELECT_INDEX_OPTION:
+            case COMPRESS_OPTION:
+            case COMPRESS_THREADS_OPTION:
+                handle_shared_io_option(c, optarg);
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -232,17 +134,23 @@ int main(int argc, char** argv) {
     }
 
 
+    start_phase(PHASE_DECODE);
     while (read_graph(stdin, graph, out, in)) {
+        stop_phase(PHASE_DECODE);
         graph_count++;
         
         if(graph_number_header){
-            fprintf(stdout, "Graph %llu:\n", graph_count);
+            fprintf(stdout, "Graph %llu:\n", input_graph_number());
         }
-        find_suitable_3_cycles(graph, out, in);
+        start_phase(PHASE_SEARCH);
+        find_suitable_3_cycles(graph, out, in, FALSE, print_suitable_3_cycle, NULL);
+        stop_phase(PHASE_SEARCH);
         if(graph_number_header){
             fprintf(stdout, "\n");
         }
+        start_phase(PHASE_DECODE);
     }
+    stop_phase(PHASE_DECODE);
     
     fprintf(stderr, "Read %llu graph%s.\n", graph_count, graph_count==1 ? "" : "s");
 
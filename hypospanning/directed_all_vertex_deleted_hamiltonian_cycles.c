@@ -19,6 +19,7 @@
 
 #include "../shared/directed_base.h"
 #include "../shared/directed_io.h"
+#include "../shared/directed_stats.h"
 
 unsigned long long int graph_count = 0;
 
@@ -136,6 +137,7 @@ void help(char *name) {
     fprintf(stderr, "Valid options\n=============\n");
     fprintf(stderr, "    -D, --digraph6\n");
     fprintf(stderr, "       Reads graphs in digraph6 format instead of watercluster format.\n");
+    help_shared_io_options(stderr);
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
@@ -162,7 +164,9 @@ int main(int argc, char** argv) {
     char *name = argv[0];
     static struct option long_options[] = {
         {"digraph6", no_argument, NULL, 'D'},
-        {"help", no_argument, NULL, 'h'}
+        {"help", no_argument, NULL, 'h'},
+        SHARED_IO_OPTIONS,
+        {NULL, 0, NULL, 0}
     };
     int option_index = 0;
 
@@ -171,6 +175,13 @@ int main(int argc, char** argv) {
             case 'D':
                 read_graph = read_graph_from_digraph6_file;
                 break;
+            case SELECT_RANGE_OPTION:
+            case SELECT_IDS_OPTION:
+            case SELECT_INDEX_OPTION:
+            case COMPRESS_OPTION:
+            case COMPRESS_THREADS_OPTION:
+                handle_shared_io_option(c, optarg);
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -184,11 +195,17 @@ int main(int argc, char** argv) {
         }
     }
 
+    start_phase(PHASE_DECODE);
     while (read_graph(stdin, graph, out, in)) {
+        stop_phase(PHASE_DECODE);
         graph_count++;
 
+        start_phase(PHASE_SEARCH);
         find_all_vertex_deleted_hamiltonian_cycles(graph, out, in);
+        stop_phase(PHASE_SEARCH);
+        start_phase(PHASE_DECODE);
     }
+    stop_phase(PHASE_DECODE);
     
     fprintf(stderr, "Read %llu graph%s.\n", graph_count, graph_count==1 ? "" : "s");
 
@@ -19,6 +19,7 @@
 
 #include "../shared/directed_base.h"
 #include "../shared/directed_io.h"
+#include "../shared/directed_stats.h"
 
 unsigned long long int graph_count = 0;
 
@@ -33,11 +34,11 @@ boolean are_all_different(int v1, int v2, int v3, int v4, int v5, int v6){
             v5!=v6;
 }
 
-inline boolean satisfies_conditions_single_vertex(GRAPH graph, DEGREES out, DEGREES in, int v){
+static inline boolean satisfies_conditions_single_vertex(GRAPH graph, DEGREES out, DEGREES in, int v){
     return !quartic || (out[v]==2 && in[v]==2);
 }
 
-inline boolean satisfies_conditions_all_vertices(GRAPH graph, DEGREES out, DEGREES in, int x, int y, int z){
+static inline boolean satisfies_conditions_all_vertices(GRAPH graph, DEGREES out, DEGREES in, int x, int y, int z){
     return !non_quartic || (out[x] + out[y] + out[z] + in[x] + in[y] + in[z] > 12);
 }
 
@@ -106,6 +107,7 @@ void help(char *name) {
     fprintf(stderr, "       Only check for a copy of Z6 with all indegrees and outdegrees equal to 2.\n");
     fprintf(stderr, "    -N, --non-quartic\n");
     fprintf(stderr, "       Only check for a copy of Z6 with at least one indegree or outdegree larger than 2.\n");
+    help_shared_io_options(stderr);
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
@@ -136,7 +138,9 @@ int main(int argc, char** argv) {
         {"quartic", no_argument, NULL, '4'},
         {"non-quartic", no_argument, NULL, 'N'},
         {"digraph6", no_argument, NULL, 'D'},
-        {"help", no_argument, NULL, 'h'}
+        {"help", no_argument, NULL, 'h'},
+        SHARED_IO_OPTIONS,
+        {NULL, 0, NULL, 0}
     };
     int option_index = 0;
 
@@ -162,6 +166,13 @@ int main(int argc, char** argv) {
             case 'D':
                 read_graph = read_graph_from_digraph6_file;
                 break;
+            case SELECT_RANGE_OPTION:
+            case SELECT_IDS_OPTION:
+            case SELECT_INDEX_OPTION:
+            case COMPRESS_OPTION:
+            case COMPRESS_THREADS_OPTION:
+                handle_shared_io_option(c, optarg);
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -180,17 +191,23 @@ int main(int argc, char** argv) {
     }
 
 
+    start_phase(PHASE_DECODE);
     while (read_graph(stdin, graph, out, in)) {
+        stop_phase(PHASE_DECODE);
         graph_count++;
 
         if(graph_number_header){
-            fprintf(stdout, "Graph %llu:\n", graph_count);
+            fprintf(stdout, "Graph %llu:\n", input_graph_number());
         }
+        start_phase(PHASE_SEARCH);
         find_z6(graph, out, in);
+        stop_phase(PHASE_SEARCH);
         if(graph_number_header){
             fprintf(stdout, "\n");
         }
+        start_phase(PHASE_DECODE);
     }
+    stop_phase(PHASE_DECODE);
     
     fprintf(stderr, "Read %llu graph%s.\n", graph_count, graph_count==1 ? "" : "s");
 
@@ -20,125 +20,31 @@
 
 #include "../shared/directed_base.h"
 #include "../shared/directed_io.h"
+#include "../shared/directed_stats.h"
+#include "../shared/directed_hamiltonian.h"
+
+#define STAGE_SEARCH 0
 
 unsigned long long int graph_count = 0;
 unsigned long long int filtered_count = 0;
 
-//================ HYPOHAMILTONIAN ===================
-
-boolean current_cycle[MAXN+1];
+//================ SUITABLE 3-CYCLES ===================
 
 /**
-  * 
-  */
-boolean continue_cycle(GRAPH graph, DEGREES out, int last, int remaining, int first) {
-    int i;
-    
-    if(remaining==0){
-        //TODO: use bitsets (although it appears this does not give a significant gain)
-        for(i = 0; i < out[last]; i++){
-            if(graph[last][i]==first){
-                return TRUE;
-            }
-        }
-        return FALSE;
-    }
-    
-    for(i = 0; i < out[last]; i++){
-        if(!current_cycle[graph[last][i]]){
-            current_cycle[graph[last][i]]=TRUE;
-            if(continue_cycle(graph, out, graph[last][i], remaining - 1, first)){
-                return TRUE;
-            }
-            current_cycle[graph[last][i]]=FALSE;
-        }
-    }
-    
-    return FALSE;
-}
-
-boolean start_cycle_through_edge(GRAPH graph, DEGREES out, int v1, int v2, int order){
-    int i;
-    //mark the start vertices as being in the cycle
-    current_cycle[v1] = TRUE;
-    current_cycle[v2] = TRUE;
-    for(i = 0; i < out[v2]; i++){
-        if(!current_cycle[graph[v2][i]]){
-            current_cycle[graph[v2][i]]=TRUE;
-            //search for cycle containing the edge (v, graph[v][i])
-            if(continue_cycle(graph, out, graph[v2][i], order - 3, v1)){
-                return TRUE;
-            }
-            current_cycle[graph[v2][i]]=FALSE;
-        }
-    }
-    current_cycle[v2] = FALSE;
-    current_cycle[v1] = FALSE;
-    
-    return FALSE;
-}
-
-//directed 3-cycle is x -> y -> z -> x
-boolean is_suitable_3_cycle(GRAPH graph, DEGREES out, DEGREES in, int x, int y, int z){
-    int v, i;
-    for(v = 1; v <= graph[0][0]; v++){
-        //clear possible previous path
-        for(i=0; i<=MAXN; i++){
-            current_cycle[i] = FALSE;
-        }
-        //mark v as being removed
-        current_cycle[v] = TRUE;
-        
-        //check for hamiltonian cycle through an edge of the 3-cycle
-        if(v == x){
-            if(!start_cycle_through_edge(graph, out, y, z, graph[0][0]-1)){
-                return FALSE;
-            }
-        } else if(v == y){
-            if(!start_cycle_through_edge(graph, out, z, x, graph[0][0]-1)){
-                return FALSE;
-            }
-        } else if(v == z){
-            if(!start_cycle_through_edge(graph, out, x, y, graph[0][0]-1)){
-                return FALSE;
-            }
-        } else {
-            if(!start_cycle_through_edge(graph, out, x, y, graph[0][0]-1) &&
-                    !start_cycle_through_edge(graph, out, y, z, graph[0][0]-1) &&
-                    !start_cycle_through_edge(graph, out, z, x, graph[0][0]-1)){
-                return FALSE;
-            }
-        }
-    }
-    return TRUE;
-}
-
-boolean has_suitable_3_cycle(GRAPH graph, DEGREES out, DEGREES in){
-    int x, i, j;
-    
-    int order = graph[0][0];
+ * Checks whether the graph has a suitable 3-cycle and keeps the statistics.
+ * The prefilter phase should be started before calling this function.
+ */
+boolean check_graph(GRAPH graph, DEGREES out, DEGREES in){
+    stop_phase(PHASE_PREFILTER);
+    start_phase(PHASE_SEARCH);
     
-    //check all 3-cycles
-    for(x = 1; x <= order; x++){
-        for(i = 0; i < out[x]; i++){
-            int y = graph[x][i];
-            for(j = 0; j < out[y]; j++){
-                int z = graph[y][j];
-                if(z!=x){
-                    int k = 0;
-                    while(k < out[z] && graph[z][k]!=x) k++;
-                    if(k < out[z]){
-                        //found a 3-cycle
-                        if(is_suitable_3_cycle(graph, out, in, x, y, z)){
-                            return TRUE;
-                        }
-                    }
-                }
-            }
-        }
+    boolean value = has_suitable_3_cycle(graph, out, in);
+    if(!value){
+        reject_at_stage(STAGE_SEARCH);
     }
     
-    return FALSE;
+    stop_phase(PHASE_SEARCH);
+    return value;
 }
 
 //====================== USAGE =======================
@@ -156,6 +62,24 @@ void help(char *name) {
     fprintf(stderr, "       Invert the filter.\n");
     fprintf(stderr, "    -u n, --update n\n");
     fprintf(stderr, "       Give an update every n graphs.\n");
+    fprintf(stderr, "    -D, --digraph6\n");
+    fprintf(stderr, "       Reads graphs in digraph6 format instead of watercluster format.\n");
+    fprintf(stderr, "    -O format, --output-format format\n");
+    fprintf(stderr, "       Writes graphs in the given format: wcf (watercluster), d6 (digraph6),\n");
+    fprintf(stderr, "       bits (bitset container), adj (adjacency lists) or multi (multi_code).\n");
+    fprintf(stderr, "       By default, or with input, the graphs are copied unchanged from the\n");
+    fprintf(stderr, "       input.\n");
+    fprintf(stderr, "    --stats=file\n");
+    fprintf(stderr, "       Write statistics about this run in JSON format to the given file.\n");
+    fprintf(stderr, "       Search nodes are only counted when compiled with -DCOUNT_SEARCH_NODES.\n");
+    fprintf(stderr, "    --hardness\n");
+    fprintf(stderr, "       Print the number of search nodes and the time after each verdict.\n");
+    fprintf(stderr, "    --hardest=k\n");
+    fprintf(stderr, "       Write the k graphs that were most expensive to check to a file. The cost\n");
+    fprintf(stderr, "       is the number of search nodes if these are counted and the time otherwise.\n");
+    fprintf(stderr, "    --hardest-file=file\n");
+    fprintf(stderr, "       The file to which the hardest graphs are written (default: hardest.wcf).\n");
+    help_shared_io_options(stderr);
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
@@ -178,25 +102,57 @@ int main(int argc, char** argv) {
     boolean invert = FALSE;
     
     boolean (*read_graph)(FILE *, GRAPH, DEGREES, DEGREES) = read_graph_from_watercluster_file;
+    void (*write_graph)(GRAPH, DEGREES, FILE *) = write_input_graph;
     
     int update = 0;
     
+    boolean show_hardness = FALSE;
+    int hardest_count = 0;
+    char *hardest_file = "hardest.wcf";
+    
 
     /*=========== commandline parsing ===========*/
 
     int c;
     char *name = argv[0];
     static struct option long_options[] = {
+        {"stats", required_argument, NULL, 0},
+        {"hardness", no_argument, NULL, 0},
+        {"hardest", required_argument, NULL, 0},
+        {"hardest-file", required_argument, NULL, 0},
         {"update", required_argument, NULL, 'u'},
         {"invert", no_argument, NULL, 'i'},
         {"filter", no_argument, NULL, 'f'},
         {"digraph6", no_argument, NULL, 'D'},
-        {"help", no_argument, NULL, 'h'}
+        {"output-format", required_argument, NULL, 'O'},
+        {"help", no_argument, NULL, 'h'},
+        SHARED_IO_OPTIONS,
+        {NULL, 0, NULL, 0}
     };
     int option_index = 0;
 
-    while ((c = getopt_long(argc, argv, "hfiu:D", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "hfiu:DO:", long_options, &option_index)) != -1) {
         switch (c) {
+            case 0:
+                switch(option_index) {
+                    case 0:
+                        enable_statistics(optarg);
+                        break;
+                    case 1:
+                        show_hardness = TRUE;
+                        break;
+                    case 2:
+                        hardest_count = atoi(optarg);
+                        break;
+                    case 3:
+                        hardest_file = optarg;
+                        break;
+                    default:
+                        fprintf(stderr, "Illegal option index %d.\n", option_index);
+                        usage(name);
+                        return EXIT_FAILURE;  
+                }
+                break;
             case 'u':
                 update = atoi(optarg);
                 break;
@@ -209,6 +165,21 @@ int main(int argc, char** argv) {
             case 'D':
                 read_graph = read_graph_from_digraph6_file;
                 break;
+            case 'O':
+                write_graph = input_writer_for_format(optarg);
+                if(write_graph == NULL){
+                    fprintf(stderr, "Unknown output format: %s -- exiting!\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case SELECT_RANGE_OPTION:
+            case SELECT_IDS_OPTION:
+            case SELECT_INDEX_OPTION:
+            case COMPRESS_OPTION:
+            case COMPRESS_THREADS_OPTION:
+                handle_shared_io_option(c, optarg);
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -225,37 +196,63 @@ int main(int argc, char** argv) {
         fprintf(stderr, "Updates are only available when filtering is enabled.\n");
         update = 0;
     }
+    if(do_filtering && show_hardness){
+        fprintf(stderr, "Hardness is only printed when filtering is disabled.\n");
+        show_hardness = FALSE;
+    }
+    if(show_hardness){
+        enable_hardness();
+    }
+    if(hardest_count){
+        enable_hardest_graphs(hardest_count, hardest_file);
+    }
 
+    register_rejection_stage(STAGE_SEARCH, "search");
 
+    start_phase(PHASE_DECODE);
     while (read_graph(stdin, graph, out, in)) {
+        stop_phase(PHASE_DECODE);
         graph_count++;
 
-        boolean value = has_suitable_3_cycle(graph, out, in);
+        start_graph();
+        start_phase(PHASE_PREFILTER);
+        boolean value = check_graph(graph, out, in);
+        graph_processed(value);
+        offer_hardest_graph(graph, out);
         if(do_filtering){
-            if(invert && !value){
-                filtered_count++;
-                write_watercluster_format(graph, out, stdout);
-            } else if(!invert && value){
+            if((invert && !value) || (!invert && value)){
                 filtered_count++;
-                write_watercluster_format(graph, out, stdout);
+                start_phase(PHASE_ENCODE);
+                write_graph(graph, out, stdout);
+                stop_phase(PHASE_ENCODE);
+                graph_written();
             }
             if(update && !(graph_count % update)){
                 fprintf(stderr, "Read: %llu. Filtered: %llu\n", graph_count, filtered_count);
             }
         } else {
             if(value){
-                fprintf(stdout, "Graph %llu has a suitable 3-cycle.\n", graph_count);
+                fprintf(stdout, "Graph %llu has a suitable 3-cycle.", input_graph_number());
             } else {
-                fprintf(stdout, "Graph %llu does not have a suitable 3-cycle.\n", graph_count);
+                fprintf(stdout, "Graph %llu does not have a suitable 3-cycle.", input_graph_number());
             }
+            if(show_hardness){
+                print_hardness(stdout);
+            }
+            fprintf(stdout, "\n");
         }
+        start_phase(PHASE_DECODE);
     }
+    stop_phase(PHASE_DECODE);
     
     fprintf(stderr, "Read %llu graph%s.\n", graph_count, graph_count==1 ? "" : "s");
     if(do_filtering){
         fprintf(stderr, "Filtered %llu graph%s that %scontain a suitable 3-cycle.\n", filtered_count, filtered_count==1 ? "" : "s", invert ? "do not " : "");
     }
 
+    write_hardest_graphs();
+    write_statistics("directed_has_suitable_3_cycle");
+
     return (EXIT_SUCCESS);
 }
 
@@ -20,86 +20,16 @@
 
 #include "../shared/directed_base.h"
 #include "../shared/directed_io.h"
+#include "../shared/directed_stats.h"
+#include "../shared/directed_z6.h"
 
 unsigned long long int graph_count = 0;
 unsigned long long int filtered_count = 0;
+unsigned long long int z6_total = 0;
 
 boolean quartic = FALSE;
 boolean non_quartic = FALSE;
 
-boolean are_all_different(int v1, int v2, int v3, int v4, int v5, int v6){
-    return v1!=v2 && v1!=v3 && v1!=v4 && v1!=v5 && v1!=v6 &&
-            v2!=v3 && v2!=v4 && v2!=v5 && v2!=v6 &&
-            v3!=v4 && v3!=v5 && v3!=v6 &&
-            v4!=v5 && v4!=v6 &&
-            v5!=v6;
-}
-
-inline boolean satisfies_conditions_single_vertex(GRAPH graph, DEGREES out, DEGREES in, int v){
-    return !quartic || (out[v]==2 && in[v]==2);
-}
-
-inline boolean satisfies_conditions_all_vertices(GRAPH graph, DEGREES out, DEGREES in, int x, int y, int z){
-    return !non_quartic || (out[x] + out[y] + out[z] + in[x] + in[y] + in[z] > 12);
-}
-
-//directed 3-cycle is x -> y -> z -> x
-boolean is_z6(GRAPH graph, DEGREES out, DEGREES in, int x, int y, int z){
-    int i, j, k;
-    for(i=0; i<out[y]; i++){
-        if(has_arc(graph, out, graph[y][i], x)){
-            for(j=0; j<out[z]; j++){
-                if(has_arc(graph, out, graph[z][j], y)){
-                    for(k=0; k<out[x]; k++){
-                        if(has_arc(graph, out, graph[x][k], z)){
-                            if(are_all_different(x,y,z,graph[x][k],graph[y][i],graph[z][j])){
-                                return TRUE;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    return FALSE;
-}
-
-boolean has_z6(GRAPH graph, DEGREES out, DEGREES in){
-    int x, i, j;
-    
-    int order = graph[0][0];
-    
-    //check all 3-cycles (we impose that x is the smallest of the three vertices)
-    for(x = 1; x <= order; x++){
-        if(satisfies_conditions_single_vertex(graph, out, in, x)){
-            for(i = 0; i < out[x]; i++){
-                int y = graph[x][i];
-                if(y < x) continue;
-                if(satisfies_conditions_single_vertex(graph, out, in, y)){
-                    for(j = 0; j < out[y]; j++){
-                        int z = graph[y][j];
-                        if(z > x){
-                            if(satisfies_conditions_single_vertex(graph, out, in, z) && 
-                                    satisfies_conditions_all_vertices(graph, out, in, x, y, z)){
-                                int k = 0;
-                                while(k < out[z] && graph[z][k]!=x) k++;
-                                if(k < out[z]){
-                                    //found a 3-cycle
-                                    if(is_z6(graph, out, in, x, y, z)){
-                                        return TRUE;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    
-    return FALSE;
-}
-
 //====================== USAGE =======================
 
 void help(char *name) {
@@ -113,12 +43,22 @@ void help(char *name) {
     fprintf(stderr, "       Only check for a copy of Z6 with all indegrees and outdegrees equal to 2.\n");
     fprintf(stderr, "    -N, --non-quartic\n");
     fprintf(stderr, "       Only check for a copy of Z6 with at least one indegree or outdegree larger than 2.\n");
+    fprintf(stderr, "    -c, --count\n");
+    fprintf(stderr, "       Count the copies of Z6 in each graph.\n");
     fprintf(stderr, "    -f, --filter\n");
     fprintf(stderr, "       Filter graphs that contain a copy of Z6.\n");
     fprintf(stderr, "    -i, --invert\n");
     fprintf(stderr, "       Invert the filter.\n");
     fprintf(stderr, "    -u n, --update n\n");
     fprintf(stderr, "       Give an update every n graphs.\n");
+    fprintf(stderr, "    -D, --digraph6\n");
+    fprintf(stderr, "       Reads graphs in digraph6 format instead of watercluster format.\n");
+    fprintf(stderr, "    -O format, --output-format format\n");
+    fprintf(stderr, "       Writes graphs in the given format: wcf (watercluster), d6 (digraph6),\n");
+    fprintf(stderr, "       bits (bitset container), adj (adjacency lists) or multi (multi_code).\n");
+    fprintf(stderr, "       By default, or with input, the graphs are copied unchanged from the\n");
+    fprintf(stderr, "       input.\n");
+    help_shared_io_options(stderr);
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
@@ -139,8 +79,10 @@ int main(int argc, char** argv) {
     
     boolean do_filtering = FALSE;
     boolean invert = FALSE;
+    boolean count = FALSE;
     
     boolean (*read_graph)(FILE *, GRAPH, DEGREES, DEGREES) = read_graph_from_watercluster_file;
+    void (*write_graph)(GRAPH, DEGREES, FILE *) = write_input_graph;
     
     int update = 0;
     
@@ -155,12 +97,16 @@ int main(int argc, char** argv) {
         {"update", required_argument, NULL, 'u'},
         {"invert", no_argument, NULL, 'i'},
         {"filter", no_argument, NULL, 'f'},
+        {"count", no_argument, NULL, 'c'},
         {"digraph6", no_argument, NULL, 'D'},
-        {"help", no_argument, NULL, 'h'}
+        {"output-format", required_argument, NULL, 'O'},
+        {"help", no_argument, NULL, 'h'},
+        SHARED_IO_OPTIONS,
+        {NULL, 0, NULL, 0}
     };
     int option_index = 0;
 
-    while ((c = getopt_long(argc, argv, "hfiu:D4N", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "hfciu:D4NO:", long_options, &option_index)) != -1) {
         switch (c) {
             case '4':
                 quartic = TRUE;
@@ -177,9 +123,27 @@ int main(int argc, char** argv) {
             case 'f':
                 do_filtering = TRUE;
                 break;
+            case 'c':
+                count = TRUE;
+                break;
             case 'D':
                 read_graph = read_graph_from_digraph6_file;
                 break;
+            case 'O':
+                write_graph = input_writer_for_format(optarg);
+                if(write_graph == NULL){
+                    fprintf(stderr, "Unknown output format: %s -- exiting!\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case SELECT_RANGE_OPTION:
+            case SELECT_IDS_OPTION:
+            case SELECT_INDEX_OPTION:
+            case COMPRESS_OPTION:
+            case COMPRESS_THREADS_OPTION:
+                handle_shared_io_option(c, optarg);
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -200,33 +164,46 @@ int main(int argc, char** argv) {
         fprintf(stderr, "Quartic and non-quartic cannot be combined -- exiting!\n");
         exit(EXIT_FAILURE);
     }
+    Z6_KIND kind = quartic ? Z6_QUARTIC : (non_quartic ? Z6_NON_QUARTIC : Z6_ANY);
 
 
+    start_phase(PHASE_DECODE);
     while (read_graph(stdin, graph, out, in)) {
+        stop_phase(PHASE_DECODE);
         graph_count++;
 
-        boolean value = has_z6(graph, out, in);
+        start_phase(PHASE_SEARCH);
+        unsigned long long int z6_count = count ? count_z6(graph, out, in, kind) : 0;
+        boolean value = count ? z6_count > 0 : has_z6(graph, out, in, kind);
+        stop_phase(PHASE_SEARCH);
+        z6_total += z6_count;
         if(do_filtering){
-            if(invert && !value){
-                filtered_count++;
-                write_watercluster_format(graph, out, stdout);
-            } else if(!invert && value){
+            if((invert && !value) || (!invert && value)){
                 filtered_count++;
-                write_watercluster_format(graph, out, stdout);
+                start_phase(PHASE_ENCODE);
+                write_graph(graph, out, stdout);
+                stop_phase(PHASE_ENCODE);
             }
             if(update && !(graph_count % update)){
                 fprintf(stderr, "Read: %llu. Filtered: %llu\n", graph_count, filtered_count);
             }
+        } else if(count){
+            fprintf(stdout, "Graph %llu has %llu cop%s of Z6.\n", input_graph_number(), z6_count, z6_count==1 ? "y" : "ies");
         } else {
             if(value){
-                fprintf(stdout, "Graph %llu has a copy of Z6.\n", graph_count);
+                fprintf(stdout, "Graph %llu has a copy of Z6.\n", input_graph_number());
             } else {
-                fprintf(stdout, "Graph %llu does not have a copy of Z6.\n", graph_count);
+                fprintf(stdout, "Graph %llu does not have a copy of Z6.\n", input_graph_number());
             }
         }
+        start_phase(PHASE_DECODE);
     }
+    stop_phase(PHASE_DECODE);
     
     fprintf(stderr, "Read %llu graph%s.\n", graph_count, graph_count==1 ? "" : "s");
+    if(count){
+        fprintf(stderr, "Found %llu cop%s of Z6.\n", z6_total, z6_total==1 ? "y" : "ies");
+    }
     if(do_filtering){
         fprintf(stderr, "Filtered %llu graph%s that %scontain a copy of Z6.\n", filtered_count, filtered_count==1 ? "" : "s", invert ? "do not " : "");
         if(quartic){
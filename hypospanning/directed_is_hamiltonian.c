@@ -19,6 +19,11 @@
 
 #include "../shared/directed_base.h"
 #include "../shared/directed_io.h"
+#include "../shared/directed_stats.h"
+#include "../shared/directed_hamiltonian.h"
+
+#define STAGE_DEGREE 0
+#define STAGE_SEARCH 1
 
 unsigned long long int graph_count = 0;
 unsigned long long int filtered_count = 0;
@@ -26,76 +31,29 @@ unsigned long long int valid_orientation_count = 0;
 
 //================ HAMILTONIAN ===================
 
-boolean current_cycle[MAXN+1];
-
 /**
-  * 
-  */
-boolean continue_cycle(GRAPH graph, DEGREES out, int last, int remaining, int first) {
-    int i;
-    
-    if(remaining==0){
-        //TODO: use bitsets (although it appears this does not give a significant gain)
-        for(i = 0; i < out[last]; i++){
-            if(graph[last][i]==first){
-                return TRUE;
-            }
-        }
+ * Checks whether the graph is hamiltonian and keeps the statistics. The
+ * prefilter phase should be started before calling this function.
+ */
+boolean check_graph(GRAPH graph, DEGREES out, DEGREES in){
+    if(!has_hamiltonian_degrees(graph, out, in)){
+        reject_at_stage(STAGE_DEGREE);
+        stop_phase(PHASE_PREFILTER);
         return FALSE;
     }
     
-    for(i = 0; i < out[last]; i++){
-        if(!current_cycle[graph[last][i]]){
-            current_cycle[graph[last][i]]=TRUE;
-            if(continue_cycle(graph, out, graph[last][i], remaining - 1, first)){
-                return TRUE;
-            }
-            current_cycle[graph[last][i]]=FALSE;
-        }
-    }
-    
-    return FALSE;
-}
-
-boolean start_cycle(GRAPH graph, DEGREES out, int startVertex, int order){
-    int i;
-    //mark the start vertex as being in the cycle
-    current_cycle[startVertex] = TRUE;
-    for(i = 0; i < out[startVertex]; i++){
-        if(!current_cycle[graph[startVertex][i]]){
-            current_cycle[graph[startVertex][i]]=TRUE;
-            //search for cycle containing the edge (v, graph[v][i])
-            if(continue_cycle(graph, out, graph[startVertex][i], order - 2, startVertex)){
-                return TRUE;
-            }
-            current_cycle[graph[startVertex][i]]=FALSE;
-        }
-    }
-    current_cycle[startVertex] = FALSE;
-    
-    return FALSE;
-}
-
-boolean is_hamiltonian(GRAPH graph, DEGREES out, DEGREES in){
-    int i;
-    
-    int order = graph[0][0];
-    
-    //check degrees
-    for(i = 1; i <= order; i++){
-        if(out[i]==0 || in[i]==0){
-            return FALSE;
-        }
-    }
-    
     valid_orientation_count++;
     
-    //clear possible previous cycle
-    for(i=0; i<=MAXN; i++){
-        current_cycle[i] = FALSE;
+    stop_phase(PHASE_PREFILTER);
+    start_phase(PHASE_SEARCH);
+    
+    boolean hamiltonian = contains_hamiltonian_cycle(graph, out);
+    if(!hamiltonian){
+        reject_at_stage(STAGE_SEARCH);
     }
     
-    return start_cycle(graph, out, 1, order);
+    stop_phase(PHASE_SEARCH);
+    return hamiltonian;
 }
 
 //====================== USAGE =======================
@@ -115,6 +73,22 @@ void help(char *name) {
     fprintf(stderr, "       Give an update every n graphs.\n");
     fprintf(stderr, "    -D, --digraph6\n");
     fprintf(stderr, "       Reads graphs in digraph6 format instead of watercluster format.\n");
+    fprintf(stderr, "    -O format, --output-format format\n");
+    fprintf(stderr, "       Writes graphs in the given format: wcf (watercluster), d6 (digraph6),\n");
+    fprintf(stderr, "       bits (bitset container), adj (adjacency lists) or multi (multi_code).\n");
+    fprintf(stderr, "       By default, or with input, the graphs are copied unchanged from the\n");
+    fprintf(stderr, "       input.\n");
+    fprintf(stderr, "    --stats=file\n");
+    fprintf(stderr, "       Write statistics about this run in JSON format to the given file.\n");
+    fprintf(stderr, "       Search nodes are only counted when compiled with -DCOUNT_SEARCH_NODES.\n");
+    fprintf(stderr, "    --hardness\n");
+    fprintf(stderr, "       Print the number of search nodes and the time after each verdict.\n");
+    fprintf(stderr, "    --hardest=k\n");
+    fprintf(stderr, "       Write the k graphs that were most expensive to check to a file. The cost\n");
+    fprintf(stderr, "       is the number of search nodes if these are counted and the time otherwise.\n");
+    fprintf(stderr, "    --hardest-file=file\n");
+    fprintf(stderr, "       The file to which the hardest graphs are written (default: hardest.wcf).\n");
+    help_shared_io_options(stderr);
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
@@ -137,25 +111,57 @@ int main(int argc, char** argv) {
     boolean invert = FALSE;
     
     boolean (*read_graph)(FILE *, GRAPH, DEGREES, DEGREES) = read_graph_from_watercluster_file;
+    void (*write_graph)(GRAPH, DEGREES, FILE *) = write_input_graph;
     
     int update = 0;
     
+    boolean show_hardness = FALSE;
+    int hardest_count = 0;
+    char *hardest_file = "hardest.wcf";
+    
 
     /*=========== commandline parsing ===========*/
 
     int c;
     char *name = argv[0];
     static struct option long_options[] = {
+        {"stats", required_argument, NULL, 0},
+        {"hardness", no_argument, NULL, 0},
+        {"hardest", required_argument, NULL, 0},
+        {"hardest-file", required_argument, NULL, 0},
         {"update", required_argument, NULL, 'u'},
         {"invert", no_argument, NULL, 'i'},
         {"filter", no_argument, NULL, 'f'},
         {"digraph6", no_argument, NULL, 'D'},
-        {"help", no_argument, NULL, 'h'}
+        {"output-format", required_argument, NULL, 'O'},
+        {"help", no_argument, NULL, 'h'},
+        SHARED_IO_OPTIONS,
+        {NULL, 0, NULL, 0}
     };
     int option_index = 0;
 
-    while ((c = getopt_long(argc, argv, "hfiu:D", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "hfiu:DO:", long_options, &option_index)) != -1) {
         switch (c) {
+            case 0:
+                switch(option_index) {
+                    case 0:
+                        enable_statistics(optarg);
+                        break;
+                    case 1:
+                        show_hardness = TRUE;
+                        break;
+                    case 2:
+                        hardest_count = atoi(optarg);
+                        break;
+                    case 3:
+                        hardest_file = optarg;
+                        break;
+                    default:
+                        fprintf(stderr, "Illegal option index %d.\n", option_index);
+                        usage(name);
+                        return EXIT_FAILURE;  
+                }
+                break;
             case 'u':
                 update = atoi(optarg);
                 break;
@@ -168,6 +174,21 @@ int main(int argc, char** argv) {
             case 'D':
                 read_graph = read_graph_from_digraph6_file;
                 break;
+            case 'O':
+                write_graph = input_writer_for_format(optarg);
+                if(write_graph == NULL){
+                    fprintf(stderr, "Unknown output format: %s -- exiting!\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case SELECT_RANGE_OPTION:
+            case SELECT_IDS_OPTION:
+            case SELECT_INDEX_OPTION:
+            case COMPRESS_OPTION:
+            case COMPRESS_THREADS_OPTION:
+                handle_shared_io_option(c, optarg);
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -184,30 +205,55 @@ int main(int argc, char** argv) {
         fprintf(stderr, "Updates are only available when filtering is enabled.\n");
         update = 0;
     }
+    if(do_filtering && show_hardness){
+        fprintf(stderr, "Hardness is only printed when filtering is disabled.\n");
+        show_hardness = FALSE;
+    }
+    if(show_hardness){
+        enable_hardness();
+    }
+    if(hardest_count){
+        enable_hardest_graphs(hardest_count, hardest_file);
+    }
 
+    register_rejection_stage(STAGE_DEGREE, "degree");
+    register_rejection_stage(STAGE_SEARCH, "search");
+
+    start_phase(PHASE_DECODE);
     while (read_graph(stdin, graph, out, in)) {
+        stop_phase(PHASE_DECODE);
         graph_count++;
 
-        boolean value = is_hamiltonian(graph, out, in);
+        start_graph();
+        start_phase(PHASE_PREFILTER);
+        boolean value = check_graph(graph, out, in);
+        graph_processed(value);
+        offer_hardest_graph(graph, out);
         if(do_filtering){
-            if(invert && !value){
-                filtered_count++;
-                write_watercluster_format(graph, out, stdout);
-            } else if(!invert && value){
+            if((invert && !value) || (!invert && value)){
                 filtered_count++;
-                write_watercluster_format(graph, out, stdout);
+                start_phase(PHASE_ENCODE);
+                write_graph(graph, out, stdout);
+                stop_phase(PHASE_ENCODE);
+                graph_written();
             }
             if(update && !(graph_count % update)){
                 fprintf(stderr, "Read: %llu. Filtered: %llu\n", graph_count, filtered_count);
             }
         } else {
             if(value){
-                fprintf(stdout, "Graph %llu is hamiltonian.\n", graph_count);
+                fprintf(stdout, "Graph %llu is hamiltonian.", input_graph_number());
             } else {
-                fprintf(stdout, "Graph %llu is not hamiltonian.\n", graph_count);
+                fprintf(stdout, "Graph %llu is not hamiltonian.", input_graph_number());
             }
+            if(show_hardness){
+                print_hardness(stdout);
+            }
+            fprintf(stdout, "\n");
         }
+        start_phase(PHASE_DECODE);
     }
+    stop_phase(PHASE_DECODE);
     
     fprintf(stderr, "Read %llu graph%s.\n", graph_count, graph_count==1 ? "" : "s");
     fprintf(stderr, "Valid orientation: %llu\n", valid_orientation_count);
@@ -215,6 +261,9 @@ int main(int argc, char** argv) {
         fprintf(stderr, "Filtered %llu graph%s.\n", filtered_count, filtered_count==1 ? "" : "s");
     }
 
+    write_hardest_graphs();
+    write_statistics("directed_is_hamiltonian");
+
     return (EXIT_SUCCESS);
 }
 
@@ -0,0 +1,243 @@
+/*
+ * 
+ * Copyright (C) 2026 Ghent University.
+ */
+
+/* This program reads directed graphs in watercluster or digraph6 format from 
+ * standard in and determines whether they are hypohamiltonian and whether they
+ * are hypotraceable. This is faster than running directed_is_hypohamiltonian
+ * and directed_is_hypotraceable separately, since the cycles and paths found
+ * for one property are used to settle the other.
+ * 
+ * 
+ * Compile with:
+ *     
+ *     cc -o directed_is_hypospanning -O4 directed_is_hypospanning.c
+ * 
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+
+#include "../shared/directed_base.h"
+#include "../shared/directed_io.h"
+#include "../shared/directed_stats.h"
+#include "../shared/directed_hamiltonian.h"
+
+unsigned long long int graph_count = 0;
+unsigned long long int filtered_count = 0;
+unsigned long long int hypohamiltonian_count = 0;
+unsigned long long int hypotraceable_count = 0;
+
+//====================== USAGE =======================
+
+void help(char *name) {
+    fprintf(stderr, "Checks directed graphs for being hypohamiltonian and for being hypotraceable.\n\n");
+    fprintf(stderr, "Usage\n=====\n");
+    fprintf(stderr, " %s [options]\n\n", name);
+    fprintf(stderr, "\nThis program can handle graphs up to %d vertices. Recompile with a larger\n", MAXN);
+    fprintf(stderr, "value for MAXN if you need to handle larger graphs.\n\n");
+    fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -f, --filter\n");
+    fprintf(stderr, "       Filter graphs that are hypohamiltonian or hypotraceable.\n");
+    fprintf(stderr, "    -i, --invert\n");
+    fprintf(stderr, "       Invert the filter.\n");
+    fprintf(stderr, "    -u n, --update n\n");
+    fprintf(stderr, "       Give an update every n graphs.\n");
+    fprintf(stderr, "    -D, --digraph6\n");
+    fprintf(stderr, "       Reads graphs in digraph6 format instead of watercluster format.\n");
+    fprintf(stderr, "    -O format, --output-format format\n");
+    fprintf(stderr, "       Writes graphs in the given format: wcf (watercluster), d6 (digraph6),\n");
+    fprintf(stderr, "       bits (bitset container), adj (adjacency lists) or multi (multi_code).\n");
+    fprintf(stderr, "       By default, or with input, the graphs are copied unchanged from the\n");
+    fprintf(stderr, "       input.\n");
+    fprintf(stderr, "    --stats=file\n");
+    fprintf(stderr, "       Write statistics about this run in JSON format to the given file.\n");
+    fprintf(stderr, "       Search nodes are only counted when compiled with -DCOUNT_SEARCH_NODES.\n");
+    fprintf(stderr, "    --hardness\n");
+    fprintf(stderr, "       Print the number of search nodes and the time after each verdict.\n");
+    fprintf(stderr, "    --hardest=k\n");
+    fprintf(stderr, "       Write the k graphs that were most expensive to check to a file. The cost\n");
+    fprintf(stderr, "       is the number of search nodes if these are counted and the time otherwise.\n");
+    fprintf(stderr, "    --hardest-file=file\n");
+    fprintf(stderr, "       The file to which the hardest graphs are written (default: hardest.wcf).\n");
+    help_shared_io_options(stderr);
+    fprintf(stderr, "    -h, --help\n");
+    fprintf(stderr, "       Print this help and return.\n");
+}
+
+void usage(char *name) {
+    fprintf(stderr, "Usage: %s [options]\n", name);
+    fprintf(stderr, "For more information type: %s -h \n\n", name);
+}
+
+/*
+ * 
+ */
+int main(int argc, char** argv) {
+    
+    GRAPH graph;
+    DEGREES out;
+    DEGREES in;
+    
+    boolean do_filtering = FALSE;
+    boolean invert = FALSE;
+    
+    boolean (*read_graph)(FILE *, GRAPH, DEGREES, DEGREES) = read_graph_from_watercluster_file;
+    void (*write_graph)(GRAPH, DEGREES, FILE *) = write_input_graph;
+    
+    int update = 0;
+    
+    boolean show_hardness = FALSE;
+    int hardest_count = 0;
+    char *hardest_file = "hardest.wcf";
+    
+
+    /*=========== commandline parsing ===========*/
+
+    int c;
+    char *name = argv[0];
+    static struct option long_options[] = {
+        {"stats", required_argument, NULL, 0},
+        {"hardness", no_argument, NULL, 0},
+        {"hardest", required_argument, NULL, 0},
+        {"hardest-file", required_argument, NULL, 0},
+        {"update", required_argument, NULL, 'u'},
+        {"invert", no_argument, NULL, 'i'},
+        {"filter", no_argument, NULL, 'f'},
+        {"digraph6", no_argument, NULL, 'D'},
+        {"output-format", required_argument, NULL, 'O'},
+        {"help", no_argument, NULL, 'h'},
+        SHARED_IO_OPTIONS,
+        {NULL, 0, NULL, 0}
+    };
+    int option_index = 0;
+
+    while ((c = getopt_long(argc, argv, "hfiu:DO:", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 0:
+                switch(option_index) {
+                    case 0:
+                        enable_statistics(optarg);
+                        break;
+                    case 1:
+                        show_hardness = TRUE;
+                        break;
+                    case 2:
+                        hardest_count = atoi(optarg);
+                        break;
+                    case 3:
+                        hardest_file = optarg;
+                        break;
+                    default:
+                        fprintf(stderr, "Illegal option index %d.\n", option_index);
+                        usage(name);
+                        return EXIT_FAILURE;  
+                }
+                break;
+            case 'u':
+                update = atoi(optarg);
+                break;
+            case 'i':
+                invert = TRUE;
+                break;
+            case 'f':
+                do_filtering = TRUE;
+                break;
+            case 'D':
+                read_graph = read_graph_from_digraph6_file;
+                break;
+            case 'O':
+                write_graph = input_writer_for_format(optarg);
+                if(write_graph == NULL){
+                    fprintf(stderr, "Unknown output format: %s -- exiting!\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case SELECT_RANGE_OPTION:
+            case SELECT_IDS_OPTION:
+            case SELECT_INDEX_OPTION:
+            case COMPRESS_OPTION:
+            case COMPRESS_THREADS_OPTION:
+                handle_shared_io_option(c, optarg);
+                break;
+            case 'h':
+                help(name);
+                return EXIT_SUCCESS;
+            case '?':
+                usage(name);
+                return EXIT_FAILURE;
+            default:
+                fprintf(stderr, "Illegal option %c.\n", c);
+                usage(name);
+                return EXIT_FAILURE;
+        }
+    }
+    if(!do_filtering && update){
+        fprintf(stderr, "Updates are only available when filtering is enabled.\n");
+        update = 0;
+    }
+    if(do_filtering && show_hardness){
+        fprintf(stderr, "Hardness is only printed when filtering is disabled.\n");
+        show_hardness = FALSE;
+    }
+    if(show_hardness){
+        enable_hardness();
+    }
+    if(hardest_count){
+        enable_hardest_graphs(hardest_count, hardest_file);
+    }
+
+    start_phase(PHASE_DECODE);
+    while (read_graph(stdin, graph, out, in)) {
+        stop_phase(PHASE_DECODE);
+        graph_count++;
+
+        start_graph();
+        start_phase(PHASE_SEARCH);
+        boolean hypohamiltonian, hypotraceable;
+        classify_hypospanning(graph, out, in, &hypohamiltonian, &hypotraceable);
+        stop_phase(PHASE_SEARCH);
+        if(hypohamiltonian) hypohamiltonian_count++;
+        if(hypotraceable) hypotraceable_count++;
+        boolean value = hypohamiltonian || hypotraceable;
+        graph_processed(value);
+        offer_hardest_graph(graph, out);
+        if(do_filtering){
+            if((invert && !value) || (!invert && value)){
+                filtered_count++;
+                start_phase(PHASE_ENCODE);
+                write_graph(graph, out, stdout);
+                stop_phase(PHASE_ENCODE);
+                graph_written();
+            }
+            if(update && !(graph_count % update)){
+                fprintf(stderr, "Read: %llu. Filtered: %llu\n", graph_count, filtered_count);
+            }
+        } else {
+            fprintf(stdout, "Graph %llu is %shypohamiltonian and %shypotraceable.",
+                    input_graph_number(), hypohamiltonian ? "" : "not ", hypotraceable ? "" : "not ");
+            if(show_hardness){
+                print_hardness(stdout);
+            }
+            fprintf(stdout, "\n");
+        }
+        start_phase(PHASE_DECODE);
+    }
+    stop_phase(PHASE_DECODE);
+    
+    fprintf(stderr, "Read %llu graph%s.\n", graph_count, graph_count==1 ? "" : "s");
+    fprintf(stderr, "Hypohamiltonian: %llu\n", hypohamiltonian_count);
+    fprintf(stderr, "Hypotraceable: %llu\n", hypotraceable_count);
+    if(do_filtering){
+        fprintf(stderr, "Filtered %llu graph%s.\n", filtered_count, filtered_count==1 ? "" : "s");
+    }
+
+    write_hardest_graphs();
+    write_statistics("directed_is_hypospanning");
+
+    return (EXIT_SUCCESS);
+}
+
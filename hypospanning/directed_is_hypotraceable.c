@@ -19,6 +19,12 @@
 
 #include "../shared/directed_base.h"
 #include "../shared/directed_io.h"
+#include "../shared/directed_stats.h"
+#include "../shared/directed_hamiltonian.h"
+
+#define STAGE_DEGREE 0
+#define STAGE_TRACEABLE 1
+#define STAGE_VERTEX_DELETED 2
 
 unsigned long long int graph_count = 0;
 unsigned long long int filtered_count = 0;
@@ -26,168 +32,31 @@ unsigned long long int valid_orientation = 0;
 
 //================ HYPOTRACEABLE ===================
 
-boolean current_path[MAXN+1];
-
 /**
-  * 
-  */
-boolean continue_path(GRAPH graph, DEGREES out, int last, int remaining) {
-    int i;
-    
-    if(remaining==0){
-        return TRUE;
-    }
-    
-    for(i = 0; i < out[last]; i++){
-        if(!current_path[graph[last][i]]){
-            current_path[graph[last][i]]=TRUE;
-            if(continue_path(graph, out, graph[last][i], remaining - 1)){
-                return TRUE;
-            }
-            current_path[graph[last][i]]=FALSE;
-        }
-    }
-    
-    return FALSE;
-}
-
-boolean start_path(GRAPH graph, DEGREES out, int start_vertex, int order){
-    int i;
-    //mark the start vertex as being in the path
-    current_path[start_vertex]=TRUE;
-    for(i = 0; i < out[start_vertex]; i++){
-        if(!current_path[graph[start_vertex][i]]){
-            current_path[graph[start_vertex][i]]=TRUE;
-            //search for path containing the edge (v, graph[v][i])
-            if(continue_path(graph, out, graph[start_vertex][i], order - 2)){
-                return TRUE;
-            }
-            current_path[graph[start_vertex][i]]=FALSE;
-        }
-    }
-    current_path[start_vertex]=FALSE;
-    
-    return FALSE;
-}
-
-boolean remaining_graph_is_traceable(GRAPH graph, DEGREES out, int remaining_order, int removed_vertex){
-    int i;
-    
-    for(i = 1; i < graph[0][0]; i++){ //we can skip last vertex, since a path needs two end points
-        if(i!=removed_vertex){
-            //we try to start the path from each vertex
-            if(start_path(graph, out, i, remaining_order)){
-                return TRUE;
-            }
-        }
-    }
-    return FALSE;
-}
-
-boolean remaining_graph_is_traceable__has_source(GRAPH graph, DEGREES out, int remaining_order, int removed_vertex, int source){
-    //If there is a hamiltonian path, then it has to start from the source
-    return start_path(graph, out, source, remaining_order);
-}
-
-boolean original_graph_is_traceable(GRAPH graph, DEGREES out, int order){
-    int i;
-    
-    for(i = 1; i <= graph[0][0]; i++){
-        //we try to start the path from each vertex
-        if(start_path(graph, out, i, order)){
-            return TRUE;
-        }
-    }
-    return FALSE;
-}
-
-boolean original_graph_is_traceable__has_source(GRAPH graph, DEGREES out, int order, int source){
-    //If there is a hamiltonian path, then it has to start from the source
-    return start_path(graph, out, source, order);
-}
-
-boolean is_hypotraceable(GRAPH graph, DEGREES out, DEGREES in){
-    int i, v, source;
-    
-    int order = graph[0][0];
-    
-    //check degrees
-    boolean has_sink = FALSE;
-    boolean has_source = FALSE;
-    
-    for(i = 1; i <= order; i++){
-        if(out[i]==1 || in[i]==1){
-            return FALSE;
-        }
-        if(out[i]==0){
-            if(has_sink){
-                return FALSE;
-            } else {
-                has_sink = TRUE;
-            }
-        }
-        if(in[i]==0){
-            if(has_source){
-                return FALSE;
-            } else {
-                has_source = TRUE;
-                source = i;
-            }
-        }
+ * Checks whether the graph is hypotraceable and keeps the statistics. The
+ * prefilter phase should be started before calling this function.
+ */
+boolean check_graph(GRAPH graph, DEGREES out, DEGREES in){
+    if(!has_hypotraceable_degrees(graph, out, in)){
+        reject_at_stage(STAGE_DEGREE);
+        stop_phase(PHASE_PREFILTER);
+        return FALSE;
     }
     
     valid_orientation++;
     
-    //clear possible previous path
-    for(i=0; i<=MAXN; i++){
-        current_path[i] = FALSE;
-    }
+    stop_phase(PHASE_PREFILTER);
+    start_phase(PHASE_SEARCH);
     
-    if(has_source){
-        if(original_graph_is_traceable__has_source(graph, out, order, source)){
-            return FALSE;
-        }
-    } else if(original_graph_is_traceable(graph, out, order)){
-        return FALSE;
+    HYPO_RESULT result = search_hypotraceable(graph, out, in);
+    if(result == HYPO_REJECTED_ORIGINAL){
+        reject_at_stage(STAGE_TRACEABLE);
+    } else if(result == HYPO_REJECTED_VERTEX_DELETED){
+        reject_at_stage(STAGE_VERTEX_DELETED);
     }
     
-    //just look for a hamiltonian path in all graphs
-    if(has_source){
-        for(v = 1; v <= order; v++){
-            //clear possible previous path
-            for(i=0; i<=MAXN; i++){
-                current_path[i] = FALSE;
-            }
-
-            current_path[v] = TRUE;
-            //we mark v as visited, so it is as if it got removed
-            if(v!=source){
-                if(!remaining_graph_is_traceable__has_source(graph, out, order-1, v, source)){
-                    return FALSE;
-                }
-            } else if(!remaining_graph_is_traceable(graph, out, order-1, v)){
-                return FALSE;
-            }
-        }
-        return TRUE;
-    } else {
-        for(v = 1; v <= order; v++){
-            //clear possible previous path
-            for(i=0; i<=MAXN; i++){
-                current_path[i] = FALSE;
-            }
-
-            current_path[v] = TRUE;
-            //we mark v as visited, so it is as if it got removed
-            if(!remaining_graph_is_traceable(graph, out, order-1, v)){
-                return FALSE;
-            }
-        }
-        return TRUE;
-    }
-    
-    
-    return TRUE;
+    stop_phase(PHASE_SEARCH);
+    return result == HYPO_ACCEPTED;
 }
 
 //====================== USAGE =======================
@@ -205,6 +74,24 @@ void help(char *name) {
     fprintf(stderr, "       Invert the filter.\n");
     fprintf(stderr, "    -u n, --update n\n");
     fprintf(stderr, "       Give an update every n graphs.\n");
+    fprintf(stderr, "    -D, --digraph6\n");
+    fprintf(stderr, "       Reads graphs in digraph6 format instead of watercluster format.\n");
+    fprintf(stderr, "    -O format, --output-format format\n");
+    fprintf(stderr, "       Writes graphs in the given format: wcf (watercluster), d6 (digraph6),\n");
+    fprintf(stderr, "       bits (bitset container), adj (adjacency lists) or multi (multi_code).\n");
+    fprintf(stderr, "       By default, or with input, the graphs are copied unchanged from the\n");
+    fprintf(stderr, "       input.\n");
+    fprintf(stderr, "    --stats=file\n");
+    fprintf(stderr, "       Write statistics about this run in JSON format to the given file.\n");
+    fprintf(stderr, "       Search nodes are only counted when compiled with -DCOUNT_SEARCH_NODES.\n");
+    fprintf(stderr, "    --hardness\n");
+    fprintf(stderr, "       Print the number of search nodes and the time after each verdict.\n");
+    fprintf(stderr, "    --hardest=k\n");
+    fprintf(stderr, "       Write the k graphs that were most expensive to check to a file. The cost\n");
+    fprintf(stderr, "       is the number of search nodes if these are counted and the time otherwise.\n");
+    fprintf(stderr, "    --hardest-file=file\n");
+    fprintf(stderr, "       The file to which the hardest graphs are written (default: hardest.wcf).\n");
+    help_shared_io_options(stderr);
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
@@ -227,25 +114,57 @@ int main(int argc, char** argv) {
     boolean invert = FALSE;
     
     boolean (*read_graph)(FILE *, GRAPH, DEGREES, DEGREES) = read_graph_from_watercluster_file;
+    void (*write_graph)(GRAPH, DEGREES, FILE *) = write_input_graph;
     
     int update = 0;
     
+    boolean show_hardness = FALSE;
+    int hardest_count = 0;
+    char *hardest_file = "hardest.wcf";
+    
 
     /*=========== commandline parsing ===========*/
 
     int c;
     char *name = argv[0];
     static struct option long_options[] = {
+        {"stats", required_argument, NULL, 0},
+        {"hardness", no_argument, NULL, 0},
+        {"hardest", required_argument, NULL, 0},
+        {"hardest-file", required_argument, NULL, 0},
         {"update", required_argument, NULL, 'u'},
         {"invert", no_argument, NULL, 'i'},
         {"filter", no_argument, NULL, 'f'},
         {"digraph6", no_argument, NULL, 'D'},
-        {"help", no_argument, NULL, 'h'}
+        {"output-format", required_argument, NULL, 'O'},
+        {"help", no_argument, NULL, 'h'},
+        SHARED_IO_OPTIONS,
+        {NULL, 0, NULL, 0}
     };
     int option_index = 0;
 
-    while ((c = getopt_long(argc, argv, "hfiu:D", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "hfiu:DO:", long_options, &option_index)) != -1) {
         switch (c) {
+            case 0:
+                switch(option_index) {
+                    case 0:
+                        enable_statistics(optarg);
+                        break;
+                    case 1:
+                        show_hardness = TRUE;
+                        break;
+                    case 2:
+                        hardest_count = atoi(optarg);
+                        break;
+                    case 3:
+                        hardest_file = optarg;
+                        break;
+                    default:
+                        fprintf(stderr, "Illegal option index %d.\n", option_index);
+                        usage(name);
+                        return EXIT_FAILURE;  
+                }
+                break;
             case 'u':
                 update = atoi(optarg);
                 break;
@@ -258,6 +177,21 @@ int main(int argc, char** argv) {
             case 'D':
                 read_graph = read_graph_from_digraph6_file;
                 break;
+            case 'O':
+                write_graph = input_writer_for_format(optarg);
+                if(write_graph == NULL){
+                    fprintf(stderr, "Unknown output format: %s -- exiting!\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case SELECT_RANGE_OPTION:
+            case SELECT_IDS_OPTION:
+            case SELECT_INDEX_OPTION:
+            case COMPRESS_OPTION:
+            case COMPRESS_THREADS_OPTION:
+                handle_shared_io_option(c, optarg);
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -274,31 +208,56 @@ int main(int argc, char** argv) {
         fprintf(stderr, "Updates are only available when filtering is enabled.\n");
         update = 0;
     }
+    if(do_filtering && show_hardness){
+        fprintf(stderr, "Hardness is only printed when filtering is disabled.\n");
+        show_hardness = FALSE;
+    }
+    if(show_hardness){
+        enable_hardness();
+    }
+    if(hardest_count){
+        enable_hardest_graphs(hardest_count, hardest_file);
+    }
 
+    register_rejection_stage(STAGE_DEGREE, "degree");
+    register_rejection_stage(STAGE_TRACEABLE, "traceable");
+    register_rejection_stage(STAGE_VERTEX_DELETED, "vertex_deleted");
 
+    start_phase(PHASE_DECODE);
     while (read_graph(stdin, graph, out, in)) {
+        stop_phase(PHASE_DECODE);
         graph_count++;
 
-        boolean value = is_hypotraceable(graph, out, in);
+        start_graph();
+        start_phase(PHASE_PREFILTER);
+        boolean value = check_graph(graph, out, in);
+        graph_processed(value);
+        offer_hardest_graph(graph, out);
         if(do_filtering){
-            if(invert && !value){
-                filtered_count++;
-                write_watercluster_format(graph, out, stdout);
-            } else if(!invert && value){
+            if((invert && !value) || (!invert && value)){
                 filtered_count++;
-                write_watercluster_format(graph, out, stdout);
+                start_phase(PHASE_ENCODE);
+                write_graph(graph, out, stdout);
+                stop_phase(PHASE_ENCODE);
+                graph_written();
             }
             if(update && !(graph_count % update)){
                 fprintf(stderr, "Read: %llu. Filtered: %llu\n", graph_count, filtered_count);
             }
         } else {
             if(value){
-                fprintf(stdout, "Graph %llu is hypotraceable.\n", graph_count);
+                fprintf(stdout, "Graph %llu is hypotraceable.", input_graph_number());
             } else {
-                fprintf(stdout, "Graph %llu is not hypotraceable.\n", graph_count);
+                fprintf(stdout, "Graph %llu is not hypotraceable.", input_graph_number());
             }
+            if(show_hardness){
+                print_hardness(stdout);
+            }
+            fprintf(stdout, "\n");
         }
+        start_phase(PHASE_DECODE);
     }
+    stop_phase(PHASE_DECODE);
     
     fprintf(stderr, "Read %llu graph%s.\n", graph_count, graph_count==1 ? "" : "s");
     fprintf(stderr, "Valid orientation: %llu\n", valid_orientation);
@@ -306,6 +265,9 @@ int main(int argc, char** argv) {
         fprintf(stderr, "Filtered %llu graph%s.\n", filtered_count, filtered_count==1 ? "" : "s");
     }
 
+    write_hardest_graphs();
+    write_statistics("directed_is_hypotraceable");
+
     return (EXIT_SUCCESS);
 }
 
@@ -16,7 +16,7 @@ void add_arc(GRAPH graph, DEGREES out, DEGREES in, int from, int to){
 }
 
 void remove_arc(GRAPH graph, DEGREES out, DEGREES in, int from, int to){
-    int i;
+    int i = 0;
     while (i < out[from] && graph[from][i] != to) i++;
     
     if(i == out[from]){
@@ -36,11 +36,27 @@ void flip_arc(GRAPH graph, DEGREES out, DEGREES in, int from, int to){
 }
 
 boolean has_arc(GRAPH graph, DEGREES out, int from, int to){
-    int i;
+    int i = 0;
     while (i < out[from] && graph[from][i] != to) i++;    
     return i != out[from];
 }
 
+BITSET neighbourhood_masks(GRAPH graph, DEGREES out, BITSET out_masks[], BITSET in_masks[]){
+    int v, i;
+    int order = graph[0][0];
+    
+    for(v = 1; v <= order; v++){
+        out_masks[v] = in_masks[v] = 0;
+    }
+    for(v = 1; v <= order; v++){
+        for(i = 0; i < out[v]; i++){
+            out_masks[v] |= BIT(graph[v][i]);
+            in_masks[graph[v][i]] |= BIT(v);
+        }
+    }
+    return (BIT(order + 1) - 1) & ~BIT(0);
+}
+
 void prepare_graph(GRAPH graph, DEGREES out, DEGREES in, int order){
     int i;
     
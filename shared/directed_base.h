@@ -19,6 +19,11 @@ typedef int boolean;
 typedef unsigned char GRAPH[MAXN + 1][MAXVAL + 1];
 typedef unsigned char DEGREES[MAXN + 1];
 
+/* A set of vertices: vertex v corresponds to bit v. */
+typedef unsigned long long int BITSET;
+
+#define BIT(v) (1ULL << (v))
+
 #ifdef	__cplusplus
 extern "C" {
 #endif
@@ -29,6 +34,12 @@ void flip_arc(GRAPH graph, DEGREES out, DEGREES in, int from, int to);
 
 boolean has_arc(GRAPH graph, DEGREES out, int from, int to);
 
+/**
+ * Stores the out-neighbours and in-neighbours of each vertex as a bitset and
+ * returns the set of all vertices.
+ */
+BITSET neighbourhood_masks(GRAPH graph, DEGREES out, BITSET out_masks[], BITSET in_masks[]);
+
 void prepare_graph(GRAPH graph, DEGREES out, DEGREES in, int order);
 void copy_graph(GRAPH orig_graph, DEGREES orig_out, DEGREES orig_in, GRAPH copy_graph, DEGREES copy_out, DEGREES copy_in);
 void relabel_graph(GRAPH orig_graph, DEGREES orig_out, DEGREES orig_in, GRAPH copy_graph, DEGREES copy_out, DEGREES copy_in, int relabeling[MAXN+1], int new_order);
@@ -0,0 +1,515 @@
+/*
+ * File:   directed_compress.c
+ * Author: nvcleemp
+ *
+ * Created on October 18, 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+#include "directed_compress.h"
+
+#define COMPRESSED_BLOCK_SIZE (1 << 18)
+#define MAX_COMPRESSION_THREADS 8
+
+//the size of the header and the trailer of a gzip member
+#define GZIP_HEADER_SIZE 10
+#define GZIP_TRAILER_SIZE 8
+
+static void insufficient_memory(){
+    fprintf(stderr, "Insufficient memory\n");
+    exit(1);
+}
+
+void write_fully(int fd, const unsigned char *data, size_t length){
+    while(length > 0){
+        ssize_t count = write(fd, data, length);
+        if(count < 0){
+            if(errno == EINTR) continue;
+            fprintf(stderr, "Error while writing output -- exiting!\n");
+            exit(1);
+        }
+        data += count;
+        length -= count;
+    }
+}
+
+COMPRESSION detect_compression(const unsigned char *magic, size_t length){
+    if(length >= 2 && magic[0] == 0x1f && magic[1] == 0x8b){
+        return COMPRESSION_GZIP;
+    } else if(length >= 4 && magic[0] == 0x28 && magic[1] == 0xb5 &&
+            magic[2] == 0x2f && magic[3] == 0xfd){
+        return COMPRESSION_ZSTD;
+    } else {
+        return COMPRESSION_NONE;
+    }
+}
+
+static const char *compression_name(COMPRESSION type){
+    return type == COMPRESSION_GZIP ? "gzip" : type == COMPRESSION_ZSTD ? "zstd" : "none";
+}
+
+//================= DECOMPRESSION ====================
+
+struct _decompressor {
+    COMPRESSION type;
+    int fd;
+
+    unsigned char *buffer;
+    size_t length;
+    size_t position;
+    boolean eof;
+
+    //FALSE while a gzip member or zstd frame is only partially decompressed
+    boolean complete;
+
+#ifdef HAVE_ZLIB
+    z_stream z;
+#endif
+#ifdef HAVE_ZSTD
+    ZSTD_DStream *zstd;
+#endif
+};
+
+DECOMPRESSOR *new_decompressor(COMPRESSION type, int fd, const unsigned char *initial, size_t initial_length){
+    DECOMPRESSOR *d = (DECOMPRESSOR *) malloc(sizeof(DECOMPRESSOR));
+
+    if(d == NULL || (d->buffer = (unsigned char *) malloc(COMPRESSED_BLOCK_SIZE)) == NULL){
+        insufficient_memory();
+    }
+    d->type = type;
+    d->fd = fd;
+    memcpy(d->buffer, initial, initial_length);
+    d->length = initial_length;
+    d->position = 0;
+    d->eof = FALSE;
+    d->complete = TRUE;
+
+    if(type == COMPRESSION_GZIP){
+#ifdef HAVE_ZLIB
+        memset(&d->z, 0, sizeof(z_stream));
+        if(inflateInit2(&d->z, 15 + 16) != Z_OK){
+            insufficient_memory();
+        }
+        return d;
+#endif
+    } else if(type == COMPRESSION_ZSTD){
+#ifdef HAVE_ZSTD
+        d->zstd = ZSTD_createDStream();
+        if(d->zstd == NULL){
+            insufficient_memory();
+        }
+        ZSTD_initDStream(d->zstd);
+        return d;
+#endif
+    }
+    fprintf(stderr, "The input is compressed with %s, but this program was compiled without support for it -- exiting!\n",
+            compression_name(type));
+    exit(1);
+}
+
+/**
+ * Makes sure that there are compressed bytes in the buffer.
+ *
+ * @return FALSE at the end of the input
+ */
+static boolean refill_compressed(DECOMPRESSOR *d){
+    if(d->position < d->length) return TRUE;
+
+    while(!d->eof){
+        ssize_t count = read(d->fd, d->buffer, COMPRESSED_BLOCK_SIZE);
+        if(count < 0){
+            if(errno == EINTR) continue;
+            fprintf(stderr, "Error while reading input -- exiting!\n");
+            exit(1);
+        } else if(count == 0){
+            d->eof = TRUE;
+        } else {
+            d->length = count;
+            d->position = 0;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+size_t read_decompressed(DECOMPRESSOR *d, unsigned char *buffer, size_t capacity){
+    size_t produced = 0;
+
+    while(produced == 0){
+        if(!refill_compressed(d)){
+            if(!d->complete){
+                fprintf(stderr, "Compressed input is truncated -- exiting!\n");
+                exit(1);
+            }
+            return 0;
+        }
+#ifdef HAVE_ZLIB
+        if(d->type == COMPRESSION_GZIP){
+            int result;
+
+            if(d->complete){
+                //the next member starts
+                inflateReset(&d->z);
+            }
+            d->z.next_in = d->buffer + d->position;
+            d->z.avail_in = d->length - d->position;
+            d->z.next_out = buffer;
+            d->z.avail_out = capacity;
+            result = inflate(&d->z, Z_NO_FLUSH);
+            if(result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR){
+                fprintf(stderr, "Corrupt gzip input -- exiting!\n");
+                exit(1);
+            }
+            d->complete = result == Z_STREAM_END;
+            d->position = d->length - d->z.avail_in;
+            produced = capacity - d->z.avail_out;
+        }
+#endif
+#ifdef HAVE_ZSTD
+        if(d->type == COMPRESSION_ZSTD){
+            ZSTD_inBuffer in = {d->buffer, d->length, d->position};
+            ZSTD_outBuffer out = {buffer, capacity, 0};
+            size_t result = ZSTD_decompressStream(d->zstd, &out, &in);
+            if(ZSTD_isError(result)){
+                fprintf(stderr, "Corrupt zstd input -- exiting!\n");
+                exit(1);
+            }
+            //concatenated frames are handled by the stream
+            d->complete = result == 0;
+            d->position = in.pos;
+            produced = out.pos;
+        }
+#endif
+    }
+    return produced;
+}
+
+void free_decompressor(DECOMPRESSOR *d){
+#ifdef HAVE_ZLIB
+    if(d->type == COMPRESSION_GZIP) inflateEnd(&d->z);
+#endif
+#ifdef HAVE_ZSTD
+    if(d->type == COMPRESSION_ZSTD) ZSTD_freeDStream(d->zstd);
+#endif
+    free(d->buffer);
+    free(d);
+}
+
+//================= COMPRESSION ====================
+
+static COMPRESSION compression = COMPRESSION_NONE;
+static int compression_level = 0;
+static int compression_threads = -1; //-1: one per processor
+
+boolean set_output_compression(const char *specification){
+    const char *colon = strchr(specification, ':');
+    size_t length = colon == NULL ? strlen(specification) : (size_t)(colon - specification);
+    int level;
+
+    if(length == 4 && strncmp(specification, "none", 4) == 0){
+        compression = COMPRESSION_NONE;
+        return colon == NULL;
+#ifdef HAVE_ZLIB
+    } else if((length == 4 && strncmp(specification, "gzip", 4) == 0) ||
+            (length == 2 && strncmp(specification, "gz", 2) == 0)){
+        compression = COMPRESSION_GZIP;
+        level = 6;
+#endif
+#ifdef HAVE_ZSTD
+    } else if((length == 4 && strncmp(specification, "zstd", 4) == 0) ||
+            (length == 3 && strncmp(specification, "zst", 3) == 0)){
+        compression = COMPRESSION_ZSTD;
+        level = 3;
+#endif
+    } else {
+        return FALSE;
+    }
+
+    if(colon != NULL){
+        char *end;
+        level = strtol(colon + 1, &end, 10);
+        if(*end != '\0' || level < 1 ||
+                level > (compression == COMPRESSION_GZIP ? 9 : 19)){
+            return FALSE;
+        }
+    }
+    compression_level = level;
+    return TRUE;
+}
+
+void set_compression_threads(int threads){
+    compression_threads = threads < 0 ? 0 : threads > MAX_COMPRESSION_THREADS ? MAX_COMPRESSION_THREADS : threads;
+}
+
+COMPRESSION output_compression(){
+    return compression;
+}
+
+const char *compression_extension(){
+    return compression == COMPRESSION_GZIP ? ".gz" : compression == COMPRESSION_ZSTD ? ".zst" : "";
+}
+
+#ifdef HAVE_ZLIB
+static void put_le32(unsigned char *p, unsigned int value){
+    p[0] = value;
+    p[1] = value >> 8;
+    p[2] = value >> 16;
+    p[3] = value >> 24;
+}
+
+/**
+ * Compresses the data into a single gzip member.
+ *
+ * @return the size of the member
+ */
+static size_t gzip_member(const unsigned char *data, size_t length, unsigned char *output, size_t capacity){
+    static const unsigned char header[GZIP_HEADER_SIZE] = {
+        0x1f, 0x8b, 8, 0, //deflate, no flags
+        0, 0, 0, 0, 0, 0xff //no time, unknown OS
+    };
+    z_stream z;
+    size_t size;
+
+    memset(&z, 0, sizeof(z_stream));
+    if(deflateInit2(&z, compression_level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK){
+        insufficient_memory();
+    }
+    z.next_in = (Bytef *) data;
+    z.avail_in = length;
+    z.next_out = output + GZIP_HEADER_SIZE;
+    z.avail_out = capacity - GZIP_HEADER_SIZE - GZIP_TRAILER_SIZE;
+    if(deflate(&z, Z_FINISH) != Z_STREAM_END){
+        fprintf(stderr, "Error while compressing output -- exiting!\n");
+        exit(1);
+    }
+    size = GZIP_HEADER_SIZE + z.total_out + GZIP_TRAILER_SIZE;
+    deflateEnd(&z);
+
+    memcpy(output, header, sizeof(header));
+    put_le32(output + size - GZIP_TRAILER_SIZE, crc32(0, data, length));
+    put_le32(output + size - 4, length);
+    return size;
+}
+#endif
+
+static size_t compressed_bound(size_t block_size){
+#ifdef HAVE_ZLIB
+    if(compression == COMPRESSION_GZIP){
+        return GZIP_HEADER_SIZE + compressBound(block_size) + GZIP_TRAILER_SIZE;
+    }
+#endif
+#ifdef HAVE_ZSTD
+    if(compression == COMPRESSION_ZSTD){
+        return ZSTD_compressBound(block_size);
+    }
+#endif
+    return block_size;
+}
+
+typedef enum {
+    JOB_FREE,
+    JOB_QUEUED,
+    JOB_DONE
+} JOB_STATE;
+
+typedef struct _compression_job {
+    const unsigned char *input;
+    size_t input_length;
+    unsigned char *buffer; //the block buffer that is exchanged with the caller
+
+    unsigned char *output;
+    size_t output_length;
+
+    COMPRESSION type;
+    JOB_STATE state;
+    struct _compression_job *next;
+} COMPRESSION_JOB;
+
+struct _compressor {
+    int fd;
+    size_t block_size;
+    size_t output_capacity;
+
+    //a ring of jobs: the next job to submit is also the oldest one
+    COMPRESSION_JOB *jobs;
+    int job_count;
+    int next;
+};
+
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work_available = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t work_done = PTHREAD_COND_INITIALIZER;
+static COMPRESSION_JOB *queue_head = NULL;
+static COMPRESSION_JOB *queue_tail = NULL;
+static int pool_size = 0;
+
+static void run_job(COMPRESSION_JOB *job){
+#ifdef HAVE_ZLIB
+    if(job->type == COMPRESSION_GZIP){
+        size_t capacity = compressed_bound(job->input_length);
+        job->output_length = gzip_member(job->input, job->input_length, job->output, capacity);
+    }
+#endif
+#ifdef HAVE_ZSTD
+    if(job->type == COMPRESSION_ZSTD){
+        size_t capacity = compressed_bound(job->input_length);
+        job->output_length = ZSTD_compress(job->output, capacity, job->input, job->input_length, compression_level);
+        if(ZSTD_isError(job->output_length)){
+            fprintf(stderr, "Error while compressing output -- exiting!\n");
+            exit(1);
+        }
+    }
+#endif
+}
+
+static void *compression_worker(void *argument){
+    pthread_mutex_lock(&pool_mutex);
+    while(TRUE){
+        COMPRESSION_JOB *job;
+
+        while(queue_head == NULL){
+            pthread_cond_wait(&work_available, &pool_mutex);
+        }
+        job = queue_head;
+        queue_head = job->next;
+        if(queue_head == NULL) queue_tail = NULL;
+        pthread_mutex_unlock(&pool_mutex);
+
+        run_job(job);
+
+        pthread_mutex_lock(&pool_mutex);
+        job->state = JOB_DONE;
+        pthread_cond_broadcast(&work_done);
+    }
+    return NULL;
+}
+
+static int start_pool(){
+    if(compression_threads < 0){
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        set_compression_threads(processors > 1 ? (int) processors : 0);
+    }
+    while(pool_size < compression_threads){
+        pthread_t thread;
+        if(pthread_create(&thread, NULL, compression_worker, NULL) != 0){
+            break;
+        }
+        pthread_detach(thread);
+        pool_size++;
+    }
+    return pool_size;
+}
+
+COMPRESSOR *new_compressor(int fd, size_t block_size){
+    COMPRESSOR *c = (COMPRESSOR *) malloc(sizeof(COMPRESSOR));
+    int i, workers = start_pool();
+
+    if(c == NULL) insufficient_memory();
+    c->fd = fd;
+    c->block_size = block_size;
+    c->output_capacity = compressed_bound(block_size);
+    //two jobs per worker keep the workers busy while the oldest is written
+    c->job_count = workers ? 2*workers : 1;
+    c->next = 0;
+    c->jobs = (COMPRESSION_JOB *) malloc(c->job_count * sizeof(COMPRESSION_JOB));
+    if(c->jobs == NULL) insufficient_memory();
+    for(i = 0; i < c->job_count; i++){
+        c->jobs[i].buffer = NULL;
+        c->jobs[i].output = NULL;
+        c->jobs[i].type = compression;
+        c->jobs[i].state = JOB_FREE;
+    }
+    return c;
+}
+
+/**
+ * Waits until the job is compressed and writes the result.
+ */
+static void write_job(COMPRESSOR *c, COMPRESSION_JOB *job){
+    pthread_mutex_lock(&pool_mutex);
+    while(job->state == JOB_QUEUED){
+        pthread_cond_wait(&work_done, &pool_mutex);
+    }
+    pthread_mutex_unlock(&pool_mutex);
+
+    if(job->state == JOB_DONE){
+        write_fully(c->fd, job->output, job->output_length);
+        job->state = JOB_FREE;
+    }
+}
+
+void compress_block(COMPRESSOR *c, unsigned char **data, size_t length){
+    COMPRESSION_JOB *job = c->jobs + c->next;
+
+    if(length == 0) return;
+
+    write_job(c, job);
+    if(job->output == NULL){
+        job->output = (unsigned char *) malloc(c->output_capacity);
+        if(job->output == NULL) insufficient_memory();
+    }
+
+    if(pool_size == 0){
+        job->input = *data;
+        job->input_length = length;
+        run_job(job);
+        write_fully(c->fd, job->output, job->output_length);
+        return;
+    }
+
+    //exchange the buffer, so the caller can fill a new block meanwhile
+    if(job->buffer == NULL){
+        job->buffer = (unsigned char *) malloc(c->block_size);
+        if(job->buffer == NULL) insufficient_memory();
+    }
+    unsigned char *free_buffer = job->buffer;
+    job->buffer = *data;
+    *data = free_buffer;
+    job->input = job->buffer;
+    job->input_length = length;
+
+    pthread_mutex_lock(&pool_mutex);
+    job->state = JOB_QUEUED;
+    job->next = NULL;
+    if(queue_tail == NULL){
+        queue_head = job;
+    } else {
+        queue_tail->next = job;
+    }
+    queue_tail = job;
+    pthread_cond_signal(&work_available);
+    pthread_mutex_unlock(&pool_mutex);
+
+    c->next = (c->next + 1) % c->job_count;
+}
+
+void finish_compressor(COMPRESSOR *c){
+    int i;
+
+    //the oldest job is the next one in the ring
+    for(i = 0; i < c->job_count; i++){
+        write_job(c, c->jobs + (c->next + i) % c->job_count);
+    }
+}
+
+void free_compressor(COMPRESSOR *c){
+    int i;
+
+    finish_compressor(c);
+    for(i = 0; i < c->job_count; i++){
+        free(c->jobs[i].buffer);
+        free(c->jobs[i].output);
+    }
+    free(c->jobs);
+    free(c);
+}
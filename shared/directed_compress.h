@@ -0,0 +1,111 @@
+/*
+ * File:   directed_compress.h
+ * Author: nvcleemp
+ *
+ * Created on October 18, 2026
+ */
+
+#ifndef DIRECTED_COMPRESS_H
+#define	DIRECTED_COMPRESS_H
+
+#include <stdio.h>
+#include <sys/types.h>
+#include "directed_base.h"
+
+/* Compressed input is recognised by its magic bytes. gzip is supported when
+ * the program is compiled with HAVE_ZLIB, zstd when it is compiled with
+ * HAVE_ZSTD. The Makefile defines these when the libraries are found.
+ *
+ * Compressed output is written as a sequence of independent blocks: every
+ * flush of an output buffer becomes a separate gzip member or zstd frame. The
+ * result is a valid compressed file. The readers here always decompress from
+ * the start of the input: an index created by directed_index is not used for
+ * compressed input. Blocks are compressed by a pool of threads when more than
+ * one processor is available.
+ */
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    COMPRESSION_NONE,
+    COMPRESSION_GZIP,
+    COMPRESSION_ZSTD
+} COMPRESSION;
+
+typedef struct _decompressor DECOMPRESSOR;
+typedef struct _compressor COMPRESSOR;
+
+/**
+ * Writes all bytes to the file descriptor, and exits if this fails.
+ */
+void write_fully(int fd, const unsigned char *data, size_t length);
+
+/**
+ * Returns the compression of a file that starts with the given bytes. At
+ * least 4 bytes are needed to recognise a compressed file.
+ */
+COMPRESSION detect_compression(const unsigned char *magic, size_t length);
+
+/**
+ * Creates a decompressor for the file descriptor. The given initial bytes
+ * were already read from the file descriptor and are decompressed first.
+ */
+DECOMPRESSOR *new_decompressor(COMPRESSION type, int fd, const unsigned char *initial, size_t initial_length);
+
+/**
+ * Reads at most capacity decompressed bytes into the buffer.
+ *
+ * @return the number of bytes read, or 0 at the end of the input
+ */
+size_t read_decompressed(DECOMPRESSOR *d, unsigned char *buffer, size_t capacity);
+
+void free_decompressor(DECOMPRESSOR *d);
+
+/**
+ * Sets the compression of all graph output that is opened afterwards. The
+ * specification is none, gzip or zstd, optionally followed by :level.
+ *
+ * @return FALSE if the specification is not valid or not supported
+ */
+boolean set_output_compression(const char *specification);
+
+/**
+ * Sets the number of threads that compress blocks (0 compresses in the
+ * calling thread).
+ */
+void set_compression_threads(int threads);
+
+COMPRESSION output_compression();
+
+/**
+ * Returns the file name extension for the output compression (e.g. ".gz").
+ */
+const char *compression_extension();
+
+/**
+ * Creates a compressor for blocks of at most block_size bytes.
+ */
+COMPRESSOR *new_compressor(int fd, size_t block_size);
+
+/**
+ * Compresses the block and writes it to the file descriptor of the compressor.
+ * If the block is compressed by another thread, the buffer is exchanged for a
+ * free buffer of the same size, so the caller can continue immediately.
+ */
+void compress_block(COMPRESSOR *c, unsigned char **data, size_t length);
+
+/**
+ * Waits until all blocks are compressed and written.
+ */
+void finish_compressor(COMPRESSOR *c);
+
+void free_compressor(COMPRESSOR *c);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* DIRECTED_COMPRESS_H */
+
@@ -0,0 +1,408 @@
+/*
+ * File:   directed_expression.c
+ * Author: nvcleemp
+ *
+ * Created on October 18, 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "directed_expression.h"
+
+typedef enum {
+    NODE_OR,
+    NODE_AND,
+    NODE_NOT,
+    NODE_COMPARE,
+    NODE_TERM
+} NODE_TYPE;
+
+typedef enum {
+    COMPARE_EQUAL,
+    COMPARE_NOT_EQUAL,
+    COMPARE_LESS,
+    COMPARE_LESS_OR_EQUAL,
+    COMPARE_GREATER,
+    COMPARE_GREATER_OR_EQUAL
+} COMPARISON;
+
+static const char *comparison_symbols[] = {"==", "!=", "<", "<=", ">", ">="};
+
+typedef struct _node NODE;
+
+struct _node {
+    NODE_TYPE type;
+
+    //the operands of ||, && and !
+    NODE **children;
+    int child_count;
+
+    //the term of a comparison or a single term
+    int term;
+    COMPARISON comparison;
+    int value;
+
+    //the estimated cost of evaluating this node
+    long long int cost;
+};
+
+struct _expression {
+    NODE *root;
+
+    int term_count;
+    const INVARIANT *terms[MAX_EXPRESSION_TERMS];
+    int values[MAX_EXPRESSION_TERMS];
+    boolean evaluated[MAX_EXPRESSION_TERMS];
+    unsigned long long int evaluations[MAX_EXPRESSION_TERMS];
+};
+
+static void insufficient_memory(){
+    fprintf(stderr, "Insufficient memory\n");
+    exit(EXIT_FAILURE);
+}
+
+//================ PARSING ===================
+
+typedef struct {
+    EXPRESSION *e;
+    const char *text;
+    int position;
+} PARSER;
+
+static void syntax_error(PARSER *p, const char *message){
+    fprintf(stderr, "%s at position %d in expression \"%s\" -- exiting!\n", message, p->position + 1, p->text);
+    exit(EXIT_FAILURE);
+}
+
+static void skip_spaces(PARSER *p){
+    while(isspace((unsigned char)p->text[p->position])) p->position++;
+}
+
+/**
+ * Skips the token if it is next in the text.
+ */
+static boolean accept(PARSER *p, const char *token){
+    size_t length = strlen(token);
+    skip_spaces(p);
+    if(strncmp(p->text + p->position, token, length)==0){
+        p->position += length;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static NODE *new_node(NODE_TYPE type){
+    NODE *node = (NODE *)malloc(sizeof(NODE));
+    if(node == NULL) insufficient_memory();
+    node->type = type;
+    node->children = NULL;
+    node->child_count = 0;
+    node->term = -1;
+    node->cost = 0;
+    return node;
+}
+
+/**
+ * Adds an operand to a || or && node. Operands of the same type are merged,
+ * so a && (b && c) has three operands.
+ */
+static void add_child(NODE *node, NODE *child){
+    if(child->type == node->type){
+        int i;
+        for(i = 0; i < child->child_count; i++){
+            add_child(node, child->children[i]);
+        }
+        free(child->children);
+        free(child);
+        return;
+    }
+    node->children = (NODE **)realloc(node->children, (node->child_count + 1)*sizeof(NODE *));
+    if(node->children == NULL) insufficient_memory();
+    node->children[node->child_count++] = child;
+    node->cost += child->cost;
+}
+
+static int compare_costs(const void *a, const void *b){
+    long long int cost_a = (*(NODE **)a)->cost;
+    long long int cost_b = (*(NODE **)b)->cost;
+    return cost_a < cost_b ? -1 : (cost_a > cost_b ? 1 : 0);
+}
+
+static NODE *parse_or(PARSER *p);
+
+static int parse_number(PARSER *p){
+    char *end;
+    skip_spaces(p);
+    long value = strtol(p->text + p->position, &end, 10);
+    if(end == p->text + p->position){
+        syntax_error(p, "Expected a number");
+    }
+    p->position = end - p->text;
+    return (int)value;
+}
+
+static NODE *parse_primary(PARSER *p){
+    skip_spaces(p);
+    if(accept(p, "(")){
+        NODE *node = parse_or(p);
+        if(!accept(p, ")")){
+            syntax_error(p, "Expected )");
+        }
+        return node;
+    }
+
+    int start = p->position;
+    while(isalnum((unsigned char)p->text[p->position]) || p->text[p->position]=='_'){
+        p->position++;
+    }
+    if(start == p->position){
+        syntax_error(p, "Expected an invariant");
+    }
+    char name[64];
+    int length = p->position - start;
+    if(length >= sizeof(name)) length = sizeof(name) - 1;
+    memcpy(name, p->text + start, length);
+    name[length] = '\0';
+    const INVARIANT *invariant = find_invariant(name);
+    if(invariant == NULL){
+        p->position = start;
+        syntax_error(p, "Unknown invariant");
+    }
+
+    NODE *node = new_node(NODE_TERM);
+    node->term = expression_term(p->e, invariant);
+    node->cost = invariant->cost;
+
+    //the longer operators have to be tried first
+    int i;
+    static const COMPARISON order[] = {
+        COMPARE_EQUAL, COMPARE_NOT_EQUAL, COMPARE_LESS_OR_EQUAL,
+        COMPARE_GREATER_OR_EQUAL, COMPARE_LESS, COMPARE_GREATER
+    };
+    for(i = 0; i < 6; i++){
+        if(accept(p, comparison_symbols[order[i]])){
+            node->type = NODE_COMPARE;
+            node->comparison = order[i];
+            node->value = parse_number(p);
+            break;
+        }
+    }
+    return node;
+}
+
+static NODE *parse_not(PARSER *p){
+    skip_spaces(p);
+    //make sure that != is not read as !
+    if(p->text[p->position]=='!' && p->text[p->position+1]!='='){
+        p->position++;
+        NODE *node = new_node(NODE_NOT);
+        node->children = (NODE **)malloc(sizeof(NODE *));
+        if(node->children == NULL) insufficient_memory();
+        node->children[0] = parse_not(p);
+        node->child_count = 1;
+        node->cost = node->children[0]->cost;
+        return node;
+    }
+    return parse_primary(p);
+}
+
+static NODE *parse_and(PARSER *p){
+    NODE *first = parse_not(p);
+    if(!accept(p, "&&")){
+        return first;
+    }
+    NODE *node = new_node(NODE_AND);
+    add_child(node, first);
+    do {
+        add_child(node, parse_not(p));
+    } while(accept(p, "&&"));
+    qsort(node->children, node->child_count, sizeof(NODE *), compare_costs);
+    return node;
+}
+
+static NODE *parse_or(PARSER *p){
+    NODE *first = parse_and(p);
+    if(!accept(p, "||")){
+        return first;
+    }
+    NODE *node = new_node(NODE_OR);
+    add_child(node, first);
+    do {
+        add_child(node, parse_and(p));
+    } while(accept(p, "||"));
+    qsort(node->children, node->child_count, sizeof(NODE *), compare_costs);
+    return node;
+}
+
+EXPRESSION *new_expression(){
+    EXPRESSION *e = (EXPRESSION *)malloc(sizeof(EXPRESSION));
+    if(e == NULL) insufficient_memory();
+    e->root = NULL;
+    e->term_count = 0;
+    return e;
+}
+
+EXPRESSION *parse_expression(const char *text){
+    EXPRESSION *e = new_expression();
+
+    PARSER p = {e, text, 0};
+    e->root = parse_or(&p);
+    skip_spaces(&p);
+    if(text[p.position] != '\0'){
+        syntax_error(&p, "Unexpected character");
+    }
+
+    return e;
+}
+
+static void free_node(NODE *node){
+    int i;
+    for(i = 0; i < node->child_count; i++){
+        free_node(node->children[i]);
+    }
+    free(node->children);
+    free(node);
+}
+
+void free_expression(EXPRESSION *e){
+    if(e->root != NULL) free_node(e->root);
+    free(e);
+}
+
+//================ TERMS ===================
+
+int expression_term(EXPRESSION *e, const INVARIANT *invariant){
+    int i;
+    for(i = 0; i < e->term_count; i++){
+        if(e->terms[i] == invariant){
+            return i;
+        }
+    }
+    if(e->term_count == MAX_EXPRESSION_TERMS){
+        fprintf(stderr, "Too many terms in expression -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    e->terms[e->term_count] = invariant;
+    e->evaluated[e->term_count] = FALSE;
+    e->evaluations[e->term_count] = 0;
+    return e->term_count++;
+}
+
+int expression_term_count(EXPRESSION *e){
+    return e->term_count;
+}
+
+const INVARIANT *expression_term_invariant(EXPRESSION *e, int term){
+    return e->terms[term];
+}
+
+void clear_expression_values(EXPRESSION *e){
+    int i;
+    for(i = 0; i < e->term_count; i++){
+        e->evaluated[i] = FALSE;
+    }
+}
+
+int expression_term_value(EXPRESSION *e, int term, GRAPH graph, DEGREES out, DEGREES in){
+    if(!e->evaluated[term]){
+        e->values[term] = e->terms[term]->compute(graph, out, in);
+        e->evaluated[term] = TRUE;
+        e->evaluations[term]++;
+    }
+    return e->values[term];
+}
+
+boolean expression_term_evaluated(EXPRESSION *e, int term){
+    return e->evaluated[term];
+}
+
+unsigned long long int expression_term_evaluations(EXPRESSION *e, int term){
+    return e->evaluations[term];
+}
+
+//================ EVALUATION ===================
+
+static boolean evaluate_node(EXPRESSION *e, NODE *node, GRAPH graph, DEGREES out, DEGREES in){
+    int i, value;
+    switch(node->type){
+        case NODE_OR:
+            for(i = 0; i < node->child_count; i++){
+                if(evaluate_node(e, node->children[i], graph, out, in)){
+                    return TRUE;
+                }
+            }
+            return FALSE;
+        case NODE_AND:
+            for(i = 0; i < node->child_count; i++){
+                if(!evaluate_node(e, node->children[i], graph, out, in)){
+                    return FALSE;
+                }
+            }
+            return TRUE;
+        case NODE_NOT:
+            return !evaluate_node(e, node->children[0], graph, out, in);
+        case NODE_TERM:
+            return expression_term_value(e, node->term, graph, out, in) != 0;
+        case NODE_COMPARE:
+            value = expression_term_value(e, node->term, graph, out, in);
+            switch(node->comparison){
+                case COMPARE_EQUAL:
+                    return value == node->value;
+                case COMPARE_NOT_EQUAL:
+                    return value != node->value;
+                case COMPARE_LESS:
+                    return value < node->value;
+                case COMPARE_LESS_OR_EQUAL:
+                    return value <= node->value;
+                case COMPARE_GREATER:
+                    return value > node->value;
+                case COMPARE_GREATER_OR_EQUAL:
+                    return value >= node->value;
+            }
+    }
+    return FALSE;
+}
+
+boolean evaluate_expression(EXPRESSION *e, GRAPH graph, DEGREES out, DEGREES in){
+    return e->root == NULL || evaluate_node(e, e->root, graph, out, in);
+}
+
+static void print_node(FILE *f, EXPRESSION *e, NODE *node, NODE_TYPE parent){
+    int i;
+    switch(node->type){
+        case NODE_OR:
+        case NODE_AND:
+            //|| binds weaker than &&, and both bind weaker than !
+            if(parent > node->type) fprintf(f, "(");
+            for(i = 0; i < node->child_count; i++){
+                if(i) fprintf(f, node->type == NODE_OR ? " || " : " && ");
+                print_node(f, e, node->children[i], node->type);
+            }
+            if(parent > node->type) fprintf(f, ")");
+            break;
+        case NODE_NOT:
+            fprintf(f, "!");
+            print_node(f, e, node->children[0], NODE_NOT);
+            break;
+        case NODE_TERM:
+            fprintf(f, "%s", e->terms[node->term]->name);
+            break;
+        case NODE_COMPARE:
+            if(parent == NODE_NOT) fprintf(f, "(");
+            fprintf(f, "%s %s %d", e->terms[node->term]->name,
+                    comparison_symbols[node->comparison], node->value);
+            if(parent == NODE_NOT) fprintf(f, ")");
+            break;
+    }
+}
+
+void print_expression(FILE *f, EXPRESSION *e){
+    if(e->root == NULL){
+        fprintf(f, "(always true)\n");
+        return;
+    }
+    print_node(f, e, e->root, NODE_OR);
+    fprintf(f, "\n");
+}
+
@@ -0,0 +1,92 @@
+/*
+ * File:   directed_expression.h
+ * Author: nvcleemp
+ *
+ * Created on October 18, 2026
+ */
+
+#ifndef DIRECTED_EXPRESSION_H
+#define	DIRECTED_EXPRESSION_H
+
+#include <stdio.h>
+#include "directed_base.h"
+#include "directed_invariants.h"
+
+/* Expressions combine invariants with comparisons and boolean operators, e.g.
+ *
+ *     hypoham && !z6 && arcs>=40
+ *
+ * An invariant on its own is true when its value is not 0. The comparisons
+ * are ==, !=, <, <=, > and >=, the boolean operators are !, && and || (in
+ * order of decreasing precedence), and parentheses can be used for grouping.
+ *
+ * The operands of && and || are reordered so the cheapest ones are evaluated
+ * first, and evaluation stops as soon as the result is known. Each invariant
+ * that occurs in the expression (a term) is computed at most once per graph.
+ */
+
+#define MAX_EXPRESSION_TERMS 64
+
+typedef struct _expression EXPRESSION;
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/**
+ * Creates an expression without operators that is always true. Terms can be
+ * added with expression_term() to compute invariants with the same cache.
+ */
+EXPRESSION *new_expression();
+
+/**
+ * Parses the expression, and exits with an error message if it is not valid.
+ */
+EXPRESSION *parse_expression(const char *text);
+
+void free_expression(EXPRESSION *e);
+
+/**
+ * Forgets the values of the terms. This should be called for each new graph.
+ */
+void clear_expression_values(EXPRESSION *e);
+
+boolean evaluate_expression(EXPRESSION *e, GRAPH graph, DEGREES out, DEGREES in);
+
+/**
+ * Returns the term for the invariant, and adds it to the terms if the
+ * invariant does not occur in the expression yet.
+ */
+int expression_term(EXPRESSION *e, const INVARIANT *invariant);
+
+int expression_term_count(EXPRESSION *e);
+
+const INVARIANT *expression_term_invariant(EXPRESSION *e, int term);
+
+/**
+ * Returns the value of the term for the current graph, and computes it if
+ * this was not done yet.
+ */
+int expression_term_value(EXPRESSION *e, int term, GRAPH graph, DEGREES out, DEGREES in);
+
+/**
+ * Returns TRUE if the value of the term is known for the current graph.
+ */
+boolean expression_term_evaluated(EXPRESSION *e, int term);
+
+/**
+ * Returns the number of graphs for which the term was computed.
+ */
+unsigned long long int expression_term_evaluations(EXPRESSION *e, int term);
+
+/**
+ * Prints the expression in the order in which it is evaluated.
+ */
+void print_expression(FILE *f, EXPRESSION *e);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* DIRECTED_EXPRESSION_H */
+
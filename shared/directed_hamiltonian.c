@@ -0,0 +1,822 @@
+/*
+ * File:   directed_hamiltonian.c
+ * Author: nvcleemp
+ *
+ * Created on October 18, 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "directed_hamiltonian.h"
+#include "directed_stats.h"
+#include "directed_quartic.h"
+
+/* The vertices on the current cycle or path are thread-local, so several
+ * threads can search different graphs at the same time.
+ */
+
+//================ CYCLES ===================
+
+static __thread boolean current_cycle[MAXN+1];
+//the successor of each vertex on the current cycle
+static __thread unsigned char cycle_successor[MAXN+1];
+
+static void clear_current_cycle(){
+    int i;
+    for(i=0; i<=MAXN; i++){
+        current_cycle[i] = FALSE;
+    }
+}
+
+static boolean continue_cycle(GRAPH graph, DEGREES out, int last, int remaining, int first) {
+    int i;
+
+    COUNT_SEARCH_NODE();
+
+    if(remaining==0){
+        //TODO: use bitsets (although it appears this does not give a significant gain)
+        for(i = 0; i < out[last]; i++){
+            if(graph[last][i]==first){
+                cycle_successor[last] = first;
+                return TRUE;
+            }
+        }
+        return FALSE;
+    }
+
+    for(i = 0; i < out[last]; i++){
+        if(!current_cycle[graph[last][i]]){
+            current_cycle[graph[last][i]]=TRUE;
+            cycle_successor[last] = graph[last][i];
+            if(continue_cycle(graph, out, graph[last][i], remaining - 1, first)){
+                return TRUE;
+            }
+            current_cycle[graph[last][i]]=FALSE;
+        }
+    }
+
+    return FALSE;
+}
+
+static boolean start_cycle(GRAPH graph, DEGREES out, int start_vertex, int order){
+    int i;
+    //mark the start vertex as being in the cycle
+    current_cycle[start_vertex] = TRUE;
+    for(i = 0; i < out[start_vertex]; i++){
+        if(!current_cycle[graph[start_vertex][i]]){
+            current_cycle[graph[start_vertex][i]]=TRUE;
+            //search for cycle containing the edge (v, graph[v][i])
+            if(continue_cycle(graph, out, graph[start_vertex][i], order - 2, start_vertex)){
+                return TRUE;
+            }
+            current_cycle[graph[start_vertex][i]]=FALSE;
+        }
+    }
+    current_cycle[start_vertex] = FALSE;
+
+    return FALSE;
+}
+
+static boolean start_cycle_through_edge(GRAPH graph, DEGREES out, int v1, int v2, int order){
+    int i;
+    //mark the start vertices as being in the cycle
+    current_cycle[v1] = TRUE;
+    current_cycle[v2] = TRUE;
+    cycle_successor[v1] = v2;
+    for(i = 0; i < out[v2]; i++){
+        if(!current_cycle[graph[v2][i]]){
+            current_cycle[graph[v2][i]]=TRUE;
+            cycle_successor[v2] = graph[v2][i];
+            //search for cycle containing the edge (v, graph[v][i])
+            if(continue_cycle(graph, out, graph[v2][i], order - 3, v1)){
+                return TRUE;
+            }
+            current_cycle[graph[v2][i]]=FALSE;
+        }
+    }
+    current_cycle[v2] = FALSE;
+    current_cycle[v1] = FALSE;
+
+    return FALSE;
+}
+
+//================ HAMILTONIAN ===================
+
+boolean has_hamiltonian_degrees(GRAPH graph, DEGREES out, DEGREES in){
+    int i;
+    for(i = 1; i <= graph[0][0]; i++){
+        if(out[i]==0 || in[i]==0){
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+boolean contains_hamiltonian_cycle(GRAPH graph, DEGREES out){
+    QUARTIC_GRAPH q;
+    if(make_quartic_graph(graph, out, &q)){
+        return quartic_contains_hamiltonian_cycle(&q);
+    }
+    clear_current_cycle();
+    return start_cycle(graph, out, 1, graph[0][0]);
+}
+
+boolean is_hamiltonian(GRAPH graph, DEGREES out, DEGREES in){
+    return has_hamiltonian_degrees(graph, out, in) &&
+            contains_hamiltonian_cycle(graph, out);
+}
+
+//================ HYPOHAMILTONIAN ===================
+
+boolean has_hypohamiltonian_degrees(GRAPH graph, DEGREES out, DEGREES in){
+    int i;
+    for(i = 1; i <= graph[0][0]; i++){
+        if(out[i]<=1 || in[i]<=1){
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* The search for a hamiltonian cycle in G and in each G-v remembers the states
+ * in which it failed. A state consists of the visited vertices, the last vertex
+ * and the first vertex of the path, and it fails if the path cannot be closed
+ * to a hamiltonian cycle. A removed vertex is just marked as visited, so the
+ * same state fails in G and in every G-v, and the searches in the different
+ * vertex-deleted subgraphs share the table.
+ *
+ * The table has a fixed size. Each bucket has two entries: the first one keeps
+ * the state with the most remaining vertices (the one that was most expensive
+ * to refute), and the second one always gets the newest state. An entry is
+ * only valid for the graph for which it was stored, so the table does not
+ * have to be cleared for each graph. Each thread has its own table.
+ */
+
+#ifndef FAILED_STATE_BUCKETS
+#define FAILED_STATE_BUCKETS (1 << 14)
+#endif
+
+//states with fewer remaining vertices are cheaper to search than to store
+#define FAILED_STATE_MIN_REMAINING 4
+
+typedef struct {
+    BITSET visited;
+    unsigned int graph; //the graph for which this entry is valid
+    unsigned char last;
+    unsigned char first;
+    unsigned char remaining;
+} FAILED_STATE;
+
+typedef struct {
+    unsigned int graph; //the current graph
+    FAILED_STATE entries[FAILED_STATE_BUCKETS][2];
+} FAILED_STATES;
+
+static __thread FAILED_STATES *failed_states = NULL;
+static pthread_key_t failed_states_key;
+static pthread_once_t failed_states_once = PTHREAD_ONCE_INIT;
+
+static void create_failed_states_key(){
+    pthread_key_create(&failed_states_key, free);
+}
+
+/**
+ * Returns the table of this thread, and starts a new graph in it.
+ */
+static FAILED_STATES *start_failed_states(){
+    if(failed_states == NULL){
+        failed_states = calloc(1, sizeof(FAILED_STATES));
+        if(failed_states == NULL){
+            fprintf(stderr, "Could not allocate the table of failed states -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+        //the table is freed when the thread exits
+        pthread_once(&failed_states_once, create_failed_states_key);
+        pthread_setspecific(failed_states_key, failed_states);
+    }
+    failed_states->graph++;
+    if(failed_states->graph == 0){
+        //the counter wrapped around, so old entries could look valid
+        memset(failed_states->entries, 0, sizeof(failed_states->entries));
+        failed_states->graph = 1;
+    }
+    return failed_states;
+}
+
+static inline FAILED_STATE *failed_state_bucket(FAILED_STATES *table, BITSET visited, int last, int first){
+    unsigned long long int key = (visited ^ ((BITSET)last << 40) ^ ((BITSET)first << 48)) * 0x9E3779B97F4A7C15ULL;
+    return table->entries[key >> 40 & (FAILED_STATE_BUCKETS - 1)];
+}
+
+static inline boolean is_same_state(FAILED_STATES *table, FAILED_STATE *entry, BITSET visited, int last, int first){
+    return entry->graph == table->graph && entry->visited == visited &&
+            entry->last == last && entry->first == first;
+}
+
+static boolean is_failed_state(FAILED_STATES *table, BITSET visited, int last, int first){
+    FAILED_STATE *bucket = failed_state_bucket(table, visited, last, first);
+    return is_same_state(table, bucket, visited, last, first) ||
+            is_same_state(table, bucket + 1, visited, last, first);
+}
+
+static void store_failed_state(FAILED_STATES *table, BITSET visited, int last, int first, int remaining){
+    FAILED_STATE *bucket = failed_state_bucket(table, visited, last, first);
+    FAILED_STATE *entry = bucket + 1;
+    if(bucket->graph != table->graph || bucket->remaining <= remaining){
+        entry = bucket;
+    }
+    entry->visited = visited;
+    entry->graph = table->graph;
+    entry->last = last;
+    entry->first = first;
+    entry->remaining = remaining;
+}
+
+/**
+ * The successor of each vertex on the current path is stored in next.
+ */
+static boolean continue_cycle_with_failed_states(GRAPH graph, DEGREES out, FAILED_STATES *table,
+        BITSET visited, int last, int remaining, int first, unsigned char next[]){
+    int i;
+
+    COUNT_SEARCH_NODE();
+
+    if(remaining==0){
+        next[last] = first;
+        return has_arc(graph, out, last, first);
+    }
+
+    if(remaining >= FAILED_STATE_MIN_REMAINING && is_failed_state(table, visited, last, first)){
+        return FALSE;
+    }
+
+    for(i = 0; i < out[last]; i++){
+        int w = graph[last][i];
+        next[last] = w;
+        if(!(visited & BIT(w)) &&
+                continue_cycle_with_failed_states(graph, out, table, visited | BIT(w), w, remaining - 1, first, next)){
+            return TRUE;
+        }
+    }
+
+    if(remaining >= FAILED_STATE_MIN_REMAINING){
+        store_failed_state(table, visited, last, first, remaining);
+    }
+    return FALSE;
+}
+
+/* Consecutive graphs in the output of a generator often differ in only a few
+ * arcs, so the hamiltonian cycle that was found last in G-v is often still a
+ * hamiltonian cycle of G-v in the next graph. Each thread keeps the last cycle
+ * for G and for each G-v, and this is checked in linear time before a new
+ * search is started.
+ */
+
+typedef struct {
+    int order;
+    boolean valid[MAXN + 1]; //slot 0 is the graph itself, slot v is G-v
+    unsigned char successor[MAXN + 1][MAXN + 1];
+} CYCLE_CACHE;
+
+static __thread CYCLE_CACHE cycle_cache;
+
+static boolean cached_cycle_is_valid(CYCLE_CACHE *cache, int v, BITSET out_masks[]){
+    int length = v ? cache->order - 1 : cache->order;
+    int u = v == 1 ? 2 : 1;
+    int i;
+    if(!cache->valid[v]){
+        return FALSE;
+    }
+    for(i = 0; i < length; i++){
+        int w = cache->successor[v][u];
+        if(!(out_masks[u] & BIT(w))){
+            return FALSE;
+        }
+        u = w;
+    }
+    return TRUE;
+}
+
+/**
+ * Searches a hamiltonian cycle in G-v, or in G if v is 0, and stores the
+ * successor of each vertex on the cycle in successor.
+ */
+static boolean search_vertex_deleted_cycle(GRAPH graph, DEGREES out, QUARTIC_GRAPH *q, FAILED_STATES *table,
+        int v, unsigned char successor[]){
+    int order = graph[0][0];
+    if(q != NULL){
+        return quartic_vertex_deleted_cycle(q, v, successor);
+    } else if(v == 0){
+        return continue_cycle_with_failed_states(graph, out, table, BIT(1), 1, order - 1, 1, successor);
+    } else {
+        //we mark v as visited, so it is as if it got removed
+        int start = v == 1 ? 2 : 1;
+        return continue_cycle_with_failed_states(graph, out, table, BIT(v) | BIT(start), start, order - 2, start,
+                successor);
+    }
+}
+
+/**
+ * Returns TRUE if G-v, or G if v is 0, has a hamiltonian cycle.
+ */
+static boolean vertex_deleted_graph_has_cycle(GRAPH graph, DEGREES out, BITSET out_masks[],
+        QUARTIC_GRAPH *q, FAILED_STATES *table, int v){
+    CYCLE_CACHE *cache = &cycle_cache;
+
+    if(cached_cycle_is_valid(cache, v, out_masks)){
+        return TRUE;
+    }
+
+    cache->valid[v] = search_vertex_deleted_cycle(graph, out, q, table, v, cache->successor[v]);
+    return cache->valid[v];
+}
+
+/**
+ * Prepares the searches in G and its vertex-deleted subgraphs: fills out_masks,
+ * and returns the quartic graph in q if the kernel for 2-in 2-out graphs can be
+ * used, or a cleared failed-state table in table otherwise.
+ */
+static void start_vertex_deleted_searches(GRAPH graph, DEGREES out, BITSET out_masks[],
+        QUARTIC_GRAPH *quartic_graph, QUARTIC_GRAPH **q, FAILED_STATES **table){
+    int order = graph[0][0];
+
+    BITSET in_masks[MAXN + 1];
+    neighbourhood_masks(graph, out, out_masks, in_masks);
+
+    if(cycle_cache.order != order){
+        //the cached cycles are only used for graphs of the same order
+        memset(cycle_cache.valid, 0, sizeof(cycle_cache.valid));
+        cycle_cache.order = order;
+    }
+
+    *q = make_quartic_graph(graph, out, quartic_graph) ? quartic_graph : NULL;
+    *table = *q == NULL ? start_failed_states() : NULL;
+}
+
+HYPO_RESULT search_hypohamiltonian(GRAPH graph, DEGREES out){
+    int v;
+
+    int order = graph[0][0];
+
+    BITSET out_masks[MAXN + 1];
+    QUARTIC_GRAPH quartic_graph, *q;
+    FAILED_STATES *table;
+    start_vertex_deleted_searches(graph, out, out_masks, &quartic_graph, &q, &table);
+
+    if(vertex_deleted_graph_has_cycle(graph, out, out_masks, q, table, 0)){
+        return HYPO_REJECTED_ORIGINAL;
+    }
+
+    //look for a hamiltonian cycle in all vertex-deleted graphs
+    for(v = 1; v <= order; v++){
+        if(!vertex_deleted_graph_has_cycle(graph, out, out_masks, q, table, v)){
+            return HYPO_REJECTED_VERTEX_DELETED;
+        }
+    }
+
+    return HYPO_ACCEPTED;
+}
+
+boolean is_hypohamiltonian(GRAPH graph, DEGREES out, DEGREES in){
+    return has_hypohamiltonian_degrees(graph, out, in) &&
+            search_hypohamiltonian(graph, out) == HYPO_ACCEPTED;
+}
+
+//================ WITNESSED GRAPHS ===================
+
+/* A witnessed graph keeps a hamiltonian cycle for each of G and G-v that has
+ * one, and remembers which of them have none. Removing an arc only breaks the
+ * witnesses that use it, and adding an arc can only create a cycle where
+ * there was none, so after a single modification only those slots are
+ * searched again.
+ */
+
+void prepare_witnessed_graph(WITNESSED_GRAPH *wg, GRAPH graph, DEGREES out, DEGREES in){
+    int v;
+    wg->graph[0][0] = graph[0][0];
+    copy_graph(graph, out, in, wg->graph, wg->out, wg->in);
+    for(v = 0; v <= graph[0][0]; v++){
+        wg->state[v] = WITNESS_UNKNOWN;
+    }
+}
+
+void witnessed_add_arc(WITNESSED_GRAPH *wg, int from, int to){
+    int v;
+    add_arc(wg->graph, wg->out, wg->in, from, to);
+    for(v = 0; v <= wg->graph[0][0]; v++){
+        //the arc is not in G-from and G-to
+        if(v != from && v != to && wg->state[v] == WITNESS_NO_CYCLE){
+            wg->state[v] = WITNESS_UNKNOWN;
+        }
+    }
+}
+
+void witnessed_remove_arc(WITNESSED_GRAPH *wg, int from, int to){
+    int v;
+    remove_arc(wg->graph, wg->out, wg->in, from, to);
+    for(v = 0; v <= wg->graph[0][0]; v++){
+        if(v != from && v != to && wg->state[v] == WITNESS_CYCLE && wg->successor[v][from] == to){
+            wg->state[v] = WITNESS_UNKNOWN;
+        }
+    }
+}
+
+void witnessed_flip_arc(WITNESSED_GRAPH *wg, int from, int to){
+    witnessed_remove_arc(wg, from, to);
+    witnessed_add_arc(wg, to, from);
+}
+
+static boolean witnessed_slot_has_cycle(WITNESSED_GRAPH *wg, QUARTIC_GRAPH *q, FAILED_STATES **table, int v){
+    if(wg->state[v] == WITNESS_UNKNOWN){
+        if(q == NULL && *table == NULL){
+            //the table is only started when a search is needed
+            *table = start_failed_states();
+        }
+        wg->state[v] = search_vertex_deleted_cycle(wg->graph, wg->out, q, *table, v, wg->successor[v]) ?
+            WITNESS_CYCLE : WITNESS_NO_CYCLE;
+    }
+    return wg->state[v] == WITNESS_CYCLE;
+}
+
+HYPO_RESULT witnessed_search_hypohamiltonian(WITNESSED_GRAPH *wg){
+    int v;
+
+    QUARTIC_GRAPH quartic_graph;
+    QUARTIC_GRAPH *q = make_quartic_graph(wg->graph, wg->out, &quartic_graph) ? &quartic_graph : NULL;
+    FAILED_STATES *table = NULL;
+
+    if(witnessed_slot_has_cycle(wg, q, &table, 0)){
+        return HYPO_REJECTED_ORIGINAL;
+    }
+
+    //a vertex-deleted subgraph that is known to have no cycle needs no search
+    for(v = 1; v <= wg->graph[0][0]; v++){
+        if(wg->state[v] == WITNESS_NO_CYCLE){
+            return HYPO_REJECTED_VERTEX_DELETED;
+        }
+    }
+
+    for(v = 1; v <= wg->graph[0][0]; v++){
+        if(!witnessed_slot_has_cycle(wg, q, &table, v)){
+            return HYPO_REJECTED_VERTEX_DELETED;
+        }
+    }
+
+    return HYPO_ACCEPTED;
+}
+
+boolean witnessed_is_hypohamiltonian(WITNESSED_GRAPH *wg){
+    return has_hypohamiltonian_degrees(wg->graph, wg->out, wg->in) &&
+            witnessed_search_hypohamiltonian(wg) == HYPO_ACCEPTED;
+}
+
+//================ HYPOTRACEABLE ===================
+
+static __thread boolean current_path[MAXN+1];
+
+static void clear_current_path(){
+    int i;
+    for(i=0; i<=MAXN; i++){
+        current_path[i] = FALSE;
+    }
+}
+
+static boolean continue_path(GRAPH graph, DEGREES out, int last, int remaining) {
+    int i;
+
+    COUNT_SEARCH_NODE();
+
+    if(remaining==0){
+        return TRUE;
+    }
+
+    for(i = 0; i < out[last]; i++){
+        if(!current_path[graph[last][i]]){
+            current_path[graph[last][i]]=TRUE;
+            if(continue_path(graph, out, graph[last][i], remaining - 1)){
+                return TRUE;
+            }
+            current_path[graph[last][i]]=FALSE;
+        }
+    }
+
+    return FALSE;
+}
+
+static boolean start_path(GRAPH graph, DEGREES out, int start_vertex, int order){
+    int i;
+    //mark the start vertex as being in the path
+    current_path[start_vertex]=TRUE;
+    for(i = 0; i < out[start_vertex]; i++){
+        if(!current_path[graph[start_vertex][i]]){
+            current_path[graph[start_vertex][i]]=TRUE;
+            //search for path containing the edge (v, graph[v][i])
+            if(continue_path(graph, out, graph[start_vertex][i], order - 2)){
+                return TRUE;
+            }
+            current_path[graph[start_vertex][i]]=FALSE;
+        }
+    }
+    current_path[start_vertex]=FALSE;
+
+    return FALSE;
+}
+
+static boolean remaining_graph_is_traceable(GRAPH graph, DEGREES out, int remaining_order, int removed_vertex){
+    int i;
+
+    for(i = 1; i < graph[0][0]; i++){ //we can skip last vertex, since a path needs two end points
+        if(i!=removed_vertex){
+            //we try to start the path from each vertex
+            if(start_path(graph, out, i, remaining_order)){
+                return TRUE;
+            }
+        }
+    }
+    return FALSE;
+}
+
+static boolean original_graph_is_traceable(GRAPH graph, DEGREES out, int order){
+    int i;
+
+    for(i = 1; i <= graph[0][0]; i++){
+        //we try to start the path from each vertex
+        if(start_path(graph, out, i, order)){
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+boolean has_hypotraceable_degrees(GRAPH graph, DEGREES out, DEGREES in){
+    int i;
+    boolean has_sink = FALSE;
+    boolean has_source = FALSE;
+
+    for(i = 1; i <= graph[0][0]; i++){
+        if(out[i]==1 || in[i]==1){
+            return FALSE;
+        }
+        if(out[i]==0){
+            if(has_sink){
+                return FALSE;
+            }
+            has_sink = TRUE;
+        }
+        if(in[i]==0){
+            if(has_source){
+                return FALSE;
+            }
+            has_source = TRUE;
+        }
+    }
+    return TRUE;
+}
+
+//if there is a source, then each hamiltonian path has to start there
+static int find_source(GRAPH graph, DEGREES in){
+    int v;
+    for(v = 1; v <= graph[0][0]; v++){
+        if(in[v]==0){
+            return v;
+        }
+    }
+    return 0;
+}
+
+static boolean graph_is_traceable(GRAPH graph, DEGREES out, int source){
+    clear_current_path();
+    if(source){
+        return start_path(graph, out, source, graph[0][0]);
+    } else {
+        return original_graph_is_traceable(graph, out, graph[0][0]);
+    }
+}
+
+static boolean vertex_deleted_graph_is_traceable(GRAPH graph, DEGREES out, int v, int source){
+    clear_current_path();
+
+    current_path[v] = TRUE;
+    //we mark v as visited, so it is as if it got removed
+    if(source && v!=source){
+        return start_path(graph, out, source, graph[0][0]-1);
+    } else {
+        return remaining_graph_is_traceable(graph, out, graph[0][0]-1, v);
+    }
+}
+
+HYPO_RESULT search_hypotraceable(GRAPH graph, DEGREES out, DEGREES in){
+    int v;
+
+    int source = find_source(graph, in);
+
+    if(graph_is_traceable(graph, out, source)){
+        return HYPO_REJECTED_ORIGINAL;
+    }
+
+    //just look for a hamiltonian path in all vertex-deleted graphs
+    for(v = 1; v <= graph[0][0]; v++){
+        if(!vertex_deleted_graph_is_traceable(graph, out, v, source)){
+            return HYPO_REJECTED_VERTEX_DELETED;
+        }
+    }
+
+    return HYPO_ACCEPTED;
+}
+
+boolean is_hypotraceable(GRAPH graph, DEGREES out, DEGREES in){
+    return has_hypotraceable_degrees(graph, out, in) &&
+            search_hypotraceable(graph, out, in) == HYPO_ACCEPTED;
+}
+
+//================ HYPOHAMILTONIAN AND HYPOTRACEABLE ===================
+
+void classify_hypospanning(GRAPH graph, DEGREES out, DEGREES in, boolean *hypohamiltonian, boolean *hypotraceable){
+    int v;
+
+    int order = graph[0][0];
+
+    *hypohamiltonian = has_hypohamiltonian_degrees(graph, out, in);
+    *hypotraceable = has_hypotraceable_degrees(graph, out, in);
+
+    if(*hypohamiltonian){
+        BITSET out_masks[MAXN + 1];
+        QUARTIC_GRAPH quartic_graph, *q;
+        FAILED_STATES *table;
+        start_vertex_deleted_searches(graph, out, out_masks, &quartic_graph, &q, &table);
+
+        //a hamiltonian graph is also traceable
+        if(vertex_deleted_graph_has_cycle(graph, out, out_masks, q, table, 0)){
+            *hypohamiltonian = *hypotraceable = FALSE;
+            return;
+        }
+        for(v = 1; v <= order; v++){
+            if(!vertex_deleted_graph_has_cycle(graph, out, out_masks, q, table, v)){
+                *hypohamiltonian = FALSE;
+                break;
+            }
+            //G-v is traceable, and since v has an in-neighbour u on the
+            //cycle, following the cycle up to u and then going to v gives a
+            //hamiltonian path in G
+            *hypotraceable = FALSE;
+        }
+    }
+
+    if(*hypotraceable){
+        int source = find_source(graph, in);
+        if(graph_is_traceable(graph, out, source)){
+            *hypotraceable = FALSE;
+            return;
+        }
+        for(v = 1; v <= order; v++){
+            if(!vertex_deleted_graph_is_traceable(graph, out, v, source)){
+                *hypotraceable = FALSE;
+                return;
+            }
+        }
+    }
+}
+
+//================ SUITABLE 3-CYCLES ===================
+
+/* A 3-cycle is suitable if each G-v has a hamiltonian cycle through one of its
+ * arcs. The 3-cycles of a graph share these searches, so the answers are kept
+ * in a table per deleted vertex v and arc. Each hamiltonian cycle of G-v that
+ * is found marks all its arcs, so most arcs are settled without a search of
+ * their own, and a 3-cycle is often decided by looking up three bits.
+ */
+
+typedef struct {
+    unsigned char (*graph)[MAXVAL + 1];
+    unsigned char *out;
+    boolean quartic;
+    QUARTIC_GRAPH quartic_graph;
+    //the arcs x -> y of G-v that were checked: bit y of checked[v][x]
+    BITSET checked[MAXN + 1][MAXN + 1];
+    //the arcs x -> y of G-v that lie on a hamiltonian cycle of G-v
+    BITSET covered[MAXN + 1][MAXN + 1];
+} ARC_COVERAGE;
+
+static void prepare_arc_coverage(ARC_COVERAGE *coverage, GRAPH graph, DEGREES out){
+    int v;
+    coverage->graph = graph;
+    coverage->out = out;
+    coverage->quartic = make_quartic_graph(graph, out, &(coverage->quartic_graph));
+    for(v = 1; v <= graph[0][0]; v++){
+        memset(coverage->checked[v], 0, (graph[0][0] + 1) * sizeof(BITSET));
+        memset(coverage->covered[v], 0, (graph[0][0] + 1) * sizeof(BITSET));
+    }
+}
+
+/**
+ * Returns TRUE if the arc x -> y lies on a hamiltonian cycle of G-v.
+ */
+static boolean arc_is_covered(ARC_COVERAGE *coverage, int v, int x, int y){
+    if(!(coverage->checked[v][x] & BIT(y))){
+        unsigned char quartic_successor[MAXN + 1];
+        unsigned char *successor;
+        boolean found;
+        if(coverage->quartic){
+            found = quartic_vertex_deleted_cycle_through_arc(&(coverage->quartic_graph), v, x, y, quartic_successor);
+            successor = quartic_successor;
+        } else {
+            int order = coverage->graph[0][0];
+            clear_current_cycle();
+            //mark v as being removed
+            current_cycle[v] = TRUE;
+            found = start_cycle_through_edge(coverage->graph, coverage->out, x, y, order - 1);
+            successor = cycle_successor;
+        }
+        coverage->checked[v][x] |= BIT(y);
+        if(found){
+            int u = x;
+            do {
+                coverage->checked[v][u] |= BIT(successor[u]);
+                coverage->covered[v][u] |= BIT(successor[u]);
+                u = successor[u];
+            } while(u != x);
+        }
+    }
+    return (coverage->covered[v][x] & BIT(y)) != 0;
+}
+
+static boolean arc_is_known_to_be_covered(ARC_COVERAGE *coverage, int v, int x, int y){
+    return (coverage->covered[v][x] & BIT(y)) != 0;
+}
+
+//directed 3-cycle is x -> y -> z -> x
+static boolean is_suitable_3_cycle_in_coverage(ARC_COVERAGE *coverage, int x, int y, int z){
+    int v;
+    for(v = 1; v <= coverage->graph[0][0]; v++){
+        //check for hamiltonian cycle through an edge of the 3-cycle
+        if(v == x){
+            if(!arc_is_covered(coverage, v, y, z)){
+                return FALSE;
+            }
+        } else if(v == y){
+            if(!arc_is_covered(coverage, v, z, x)){
+                return FALSE;
+            }
+        } else if(v == z){
+            if(!arc_is_covered(coverage, v, x, y)){
+                return FALSE;
+            }
+        } else if(!arc_is_known_to_be_covered(coverage, v, x, y) &&
+                !arc_is_known_to_be_covered(coverage, v, y, z) &&
+                !arc_is_known_to_be_covered(coverage, v, z, x)){
+            //only search if none of the arcs is known to lie on a cycle
+            if(!arc_is_covered(coverage, v, x, y) &&
+                    !arc_is_covered(coverage, v, y, z) &&
+                    !arc_is_covered(coverage, v, z, x)){
+                return FALSE;
+            }
+        }
+    }
+    return TRUE;
+}
+
+boolean is_suitable_3_cycle(GRAPH graph, DEGREES out, DEGREES in, int x, int y, int z){
+    ARC_COVERAGE coverage;
+    prepare_arc_coverage(&coverage, graph, out);
+    return is_suitable_3_cycle_in_coverage(&coverage, x, y, z);
+}
+
+int find_suitable_3_cycles(GRAPH graph, DEGREES out, DEGREES in, boolean first_only,
+        void (*found)(int x, int y, int z, void *data), void *data){
+    int x, i, j;
+    int count = 0;
+
+    int order = graph[0][0];
+
+    ARC_COVERAGE coverage;
+    prepare_arc_coverage(&coverage, graph, out);
+
+    //check all 3-cycles (we impose that x is the smallest of the three vertices)
+    for(x = 1; x <= order; x++){
+        for(i = 0; i < out[x]; i++){
+            int y = graph[x][i];
+            if(y < x) continue;
+            for(j = 0; j < out[y]; j++){
+                int z = graph[y][j];
+                if(z > x && has_arc(graph, out, z, x) &&
+                        is_suitable_3_cycle_in_coverage(&coverage, x, y, z)){
+                    count++;
+                    if(found != NULL){
+                        found(x, y, z, data);
+                    }
+                    if(first_only){
+                        return count;
+                    }
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+boolean has_suitable_3_cycle(GRAPH graph, DEGREES out, DEGREES in){
+    return find_suitable_3_cycles(graph, out, in, TRUE, NULL, NULL) > 0;
+}
@@ -0,0 +1,147 @@
+/*
+ * File:   directed_hamiltonian.h
+ * Author: nvcleemp
+ *
+ * Created on October 18, 2026
+ */
+
+#ifndef DIRECTED_HAMILTONIAN_H
+#define	DIRECTED_HAMILTONIAN_H
+
+#include "directed_base.h"
+
+/* The searches for hamiltonian cycles and paths that are used by the programs
+ * in hypospanning. The kernels do not collect statistics themselves: each
+ * property has a degree prefilter and a search, so a program can time and
+ * count both separately.
+ */
+
+/* The outcome of the search for a hypohamiltonian or hypotraceable graph. */
+typedef enum {
+    HYPO_ACCEPTED,
+    HYPO_REJECTED_ORIGINAL, //the graph itself is hamiltonian (or traceable)
+    HYPO_REJECTED_VERTEX_DELETED //some vertex-deleted subgraph is not
+} HYPO_RESULT;
+
+typedef enum {
+    WITNESS_UNKNOWN,
+    WITNESS_CYCLE, //the successors of the cycle are stored
+    WITNESS_NO_CYCLE
+} WITNESS_STATE;
+
+/* A graph together with a hamiltonian cycle (a witness) for the graph itself
+ * (slot 0) and for each vertex-deleted subgraph G-v (slot v). The arcs should
+ * only be changed with the functions below, so the states stay correct.
+ */
+typedef struct {
+    GRAPH graph;
+    DEGREES out;
+    DEGREES in;
+    WITNESS_STATE state[MAXN + 1];
+    unsigned char successor[MAXN + 1][MAXN + 1];
+} WITNESSED_GRAPH;
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/**
+ * Returns FALSE if the degrees show that the graph is not hamiltonian, i.e.,
+ * if there is a sink or a source.
+ */
+boolean has_hamiltonian_degrees(GRAPH graph, DEGREES out, DEGREES in);
+
+boolean contains_hamiltonian_cycle(GRAPH graph, DEGREES out);
+
+boolean is_hamiltonian(GRAPH graph, DEGREES out, DEGREES in);
+
+/**
+ * Returns FALSE if the degrees show that the graph is not hypohamiltonian,
+ * i.e., if there is a vertex with in-degree or out-degree at most 1.
+ */
+boolean has_hypohamiltonian_degrees(GRAPH graph, DEGREES out, DEGREES in);
+
+/**
+ * Searches a hamiltonian cycle in the graph and in each vertex-deleted
+ * subgraph. The graph should pass has_hypohamiltonian_degrees().
+ */
+HYPO_RESULT search_hypohamiltonian(GRAPH graph, DEGREES out);
+
+boolean is_hypohamiltonian(GRAPH graph, DEGREES out, DEGREES in);
+
+/**
+ * Copies the graph into wg. No witnesses are known yet.
+ */
+void prepare_witnessed_graph(WITNESSED_GRAPH *wg, GRAPH graph, DEGREES out, DEGREES in);
+
+/**
+ * Adds the arc. Only the slots without a cycle need to be checked again.
+ */
+void witnessed_add_arc(WITNESSED_GRAPH *wg, int from, int to);
+
+/**
+ * Removes the arc. Only the slots whose witness uses the arc need to be
+ * checked again.
+ */
+void witnessed_remove_arc(WITNESSED_GRAPH *wg, int from, int to);
+
+void witnessed_flip_arc(WITNESSED_GRAPH *wg, int from, int to);
+
+/**
+ * Does the same as search_hypohamiltonian(), but only searches the slots of
+ * which the state is unknown, and stores the cycles that are found. A copy of
+ * wg can be used to try a modification and keep the original witnesses.
+ */
+HYPO_RESULT witnessed_search_hypohamiltonian(WITNESSED_GRAPH *wg);
+
+boolean witnessed_is_hypohamiltonian(WITNESSED_GRAPH *wg);
+
+/**
+ * Returns FALSE if the degrees show that the graph is not hypotraceable, i.e.,
+ * if there is a vertex with in-degree or out-degree 1, or if there are two
+ * sinks or two sources.
+ */
+boolean has_hypotraceable_degrees(GRAPH graph, DEGREES out, DEGREES in);
+
+/**
+ * Searches a hamiltonian path in the graph and in each vertex-deleted
+ * subgraph. The graph should pass has_hypotraceable_degrees().
+ */
+HYPO_RESULT search_hypotraceable(GRAPH graph, DEGREES out, DEGREES in);
+
+boolean is_hypotraceable(GRAPH graph, DEGREES out, DEGREES in);
+
+/**
+ * Determines whether the graph is hypohamiltonian and whether it is
+ * hypotraceable. Each cycle or path that is found for one property is used to
+ * settle the other: a hamiltonian cycle in G rules out both, and a hamiltonian
+ * cycle in G-v shows that G-v is traceable and, since v has an in-neighbour,
+ * also that G is traceable. In particular a hypohamiltonian graph is never
+ * hypotraceable.
+ */
+void classify_hypospanning(GRAPH graph, DEGREES out, DEGREES in, boolean *hypohamiltonian, boolean *hypotraceable);
+
+/**
+ * Returns TRUE if the directed 3-cycle x -> y -> z -> x is suitable, i.e.,
+ * if each vertex-deleted subgraph has a hamiltonian cycle through an arc of
+ * this 3-cycle.
+ */
+boolean is_suitable_3_cycle(GRAPH graph, DEGREES out, DEGREES in, int x, int y, int z);
+
+boolean has_suitable_3_cycle(GRAPH graph, DEGREES out, DEGREES in);
+
+/**
+ * Calls found for each suitable 3-cycle x -> y -> z -> x with x the smallest
+ * vertex, and returns the number of suitable 3-cycles. If first_only is TRUE,
+ * the search stops at the first one. The searches in the vertex-deleted
+ * subgraphs are shared by all 3-cycles.
+ */
+int find_suitable_3_cycles(GRAPH graph, DEGREES out, DEGREES in, boolean first_only,
+        void (*found)(int x, int y, int z, void *data), void *data);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* DIRECTED_HAMILTONIAN_H */
+
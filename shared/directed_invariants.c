@@ -0,0 +1,275 @@
+/*
+ * File:   directed_invariants.c
+ * Author: nvcleemp
+ *
+ * Created on October 18, 2026
+ */
+
+#include <string.h>
+#include <limits.h>
+#include "directed_invariants.h"
+#include "directed_hamiltonian.h"
+#include "directed_z6.h"
+
+int arc_count(GRAPH graph, DEGREES out, DEGREES in){
+    int i;
+    int count = 0;
+    for(i=1; i<=graph[0][0]; i++){
+        count+=out[i];
+    }
+    return count;
+}
+
+int sink_count(GRAPH graph, DEGREES out, DEGREES in){
+    int i;
+    int count = 0;
+    for(i=1; i<=graph[0][0]; i++){
+        if(out[i]==0) count++;
+    }
+    return count;
+}
+
+int source_count(GRAPH graph, DEGREES out, DEGREES in){
+    int i;
+    int count = 0;
+    for(i=1; i<=graph[0][0]; i++){
+        if(in[i]==0) count++;
+    }
+    return count;
+}
+
+int minimum_out_degree(GRAPH graph, DEGREES out, DEGREES in){
+    int i;
+    int minimum = MAXVAL + 1;
+    for(i=1; i<=graph[0][0]; i++){
+        if(out[i] < minimum) minimum = out[i];
+    }
+    return graph[0][0] ? minimum : 0;
+}
+
+int minimum_in_degree(GRAPH graph, DEGREES out, DEGREES in){
+    int i;
+    int minimum = MAXVAL + 1;
+    for(i=1; i<=graph[0][0]; i++){
+        if(in[i] < minimum) minimum = in[i];
+    }
+    return graph[0][0] ? minimum : 0;
+}
+
+//================= BITSET KERNELS ====================
+
+/* The remaining invariants work on the out-neighbourhoods and in-neighbourhoods
+ * of the vertices as bitsets, so each step of a search handles all vertices of
+ * a set at once.
+ */
+
+/**
+ * Returns the union of the neighbourhoods of the vertices in the set.
+ */
+static inline BITSET neighbours_of_set(BITSET set, BITSET masks[]){
+    BITSET neighbours = 0;
+    while(set){
+        neighbours |= masks[__builtin_ctzll(set)];
+        set &= set - 1;
+    }
+    return neighbours;
+}
+
+/**
+ * Returns the vertices that can be reached from the vertices in the set
+ * (including these vertices). With the in-masks these are the vertices from
+ * which the set can be reached.
+ */
+static BITSET reachable_set(BITSET set, BITSET masks[]){
+    BITSET reached = set;
+    BITSET frontier = set;
+    while(frontier){
+        frontier = neighbours_of_set(frontier, masks) & ~reached;
+        reached |= frontier;
+    }
+    return reached;
+}
+
+int two_cycle_count(GRAPH graph, DEGREES out, DEGREES in){
+    BITSET out_masks[MAXN + 1], in_masks[MAXN + 1];
+    int v;
+    int count = 0;
+    neighbourhood_masks(graph, out, out_masks, in_masks);
+    for(v = 1; v <= graph[0][0]; v++){
+        //only the neighbours larger than v
+        count += __builtin_popcountll(out_masks[v] & in_masks[v] & ~(BIT(v + 1) - 1));
+    }
+    return count;
+}
+
+int three_cycle_count(GRAPH graph, DEGREES out, DEGREES in){
+    BITSET out_masks[MAXN + 1], in_masks[MAXN + 1];
+    int x, i;
+    int count = 0;
+    neighbourhood_masks(graph, out, out_masks, in_masks);
+    for(x = 1; x <= graph[0][0]; x++){
+        for(i = 0; i < out[x]; i++){
+            //the vertices z with x -> y -> z -> x
+            count += __builtin_popcountll(out_masks[graph[x][i]] & in_masks[x]);
+        }
+    }
+    //each cycle was found once for each of its arcs
+    return count / 3;
+}
+
+int girth(GRAPH graph, DEGREES out, DEGREES in){
+    BITSET out_masks[MAXN + 1], in_masks[MAXN + 1];
+    int v, length;
+    int shortest = 0;
+    neighbourhood_masks(graph, out, out_masks, in_masks);
+    for(v = 1; v <= graph[0][0]; v++){
+        //breadth-first search from v until v is reached again
+        BITSET reached = 0;
+        BITSET frontier = out_masks[v];
+        for(length = 1; frontier && (!shortest || length < shortest); length++){
+            if(frontier & BIT(v)){
+                shortest = length;
+                break;
+            }
+            reached |= frontier;
+            frontier = neighbours_of_set(frontier, out_masks) & ~reached;
+        }
+        if(shortest == 2){
+            break;
+        }
+    }
+    return shortest;
+}
+
+int diameter(GRAPH graph, DEGREES out, DEGREES in){
+    BITSET out_masks[MAXN + 1], in_masks[MAXN + 1];
+    BITSET all = neighbourhood_masks(graph, out, out_masks, in_masks);
+    int v, distance;
+    int largest = 0;
+    for(v = 1; v <= graph[0][0]; v++){
+        BITSET reached = BIT(v);
+        BITSET frontier = BIT(v);
+        for(distance = 0; reached != all; distance++){
+            frontier = neighbours_of_set(frontier, out_masks) & ~reached;
+            if(!frontier){
+                //some vertex cannot be reached from v
+                return -1;
+            }
+            reached |= frontier;
+        }
+        if(distance > largest) largest = distance;
+    }
+    return largest;
+}
+
+int strong_component_count(GRAPH graph, DEGREES out, DEGREES in){
+    BITSET out_masks[MAXN + 1], in_masks[MAXN + 1];
+    BITSET remaining = neighbourhood_masks(graph, out, out_masks, in_masks);
+    int count = 0;
+    while(remaining){
+        BITSET start = remaining & -remaining;
+        //the component of start is reachable in both directions
+        remaining &= ~(reachable_set(start, out_masks) & reachable_set(start, in_masks));
+        count++;
+    }
+    return count;
+}
+
+typedef struct {
+    BITSET *out_masks;
+    BITSET *in_masks;
+    int count;
+} CYCLE_COUNT;
+
+/**
+ * Counts the ways to extend the path from the first vertex to last through
+ * the unvisited vertices to a hamiltonian cycle. The count saturates at
+ * INT_MAX.
+ */
+static void count_hamiltonian_cycles(CYCLE_COUNT *cc, int last, BITSET unvisited, BITSET first){
+    if(!unvisited){
+        if(cc->out_masks[last] & first) cc->count++;
+        return;
+    }
+    
+    //every unvisited vertex still needs a predecessor and a successor
+    BITSET rest = unvisited;
+    while(rest){
+        int w = __builtin_ctzll(rest);
+        rest &= rest - 1;
+        if(!(cc->in_masks[w] & (unvisited | BIT(last))) ||
+                !(cc->out_masks[w] & (unvisited | first))){
+            return;
+        }
+    }
+    
+    BITSET next = cc->out_masks[last] & unvisited;
+    while(next && cc->count < INT_MAX){
+        int w = __builtin_ctzll(next);
+        next &= next - 1;
+        count_hamiltonian_cycles(cc, w, unvisited & ~BIT(w), first);
+    }
+}
+
+int hamiltonian_cycle_count(GRAPH graph, DEGREES out, DEGREES in){
+    BITSET out_masks[MAXN + 1], in_masks[MAXN + 1];
+    BITSET all = neighbourhood_masks(graph, out, out_masks, in_masks);
+    CYCLE_COUNT cc = {out_masks, in_masks, 0};
+    
+    if(graph[0][0] < 2 || sink_count(graph, out, in) || source_count(graph, out, in)){
+        return 0;
+    }
+    
+    //each cycle is counted once, starting from vertex 1
+    count_hamiltonian_cycles(&cc, 1, all & ~BIT(1), BIT(1));
+    return cc.count;
+}
+
+static int z6_property(GRAPH graph, DEGREES out, DEGREES in){
+    return has_z6(graph, out, in, Z6_ANY);
+}
+
+static int z6_count(GRAPH graph, DEGREES out, DEGREES in){
+    unsigned long long int count = count_z6(graph, out, in, Z6_ANY);
+    return count > INT_MAX ? INT_MAX : (int) count;
+}
+
+static const INVARIANT invariants[] = {
+    {"arcs", "the number of arcs in the graph", 1, arc_count},
+    {"sink", "the number of sinks in the graph", 1, sink_count},
+    {"source", "the number of sources in the graph", 1, source_count},
+    {"minout", "the minimum out-degree of the graph", 1, minimum_out_degree},
+    {"minin", "the minimum in-degree of the graph", 1, minimum_in_degree},
+    {"2cycles", "the number of directed 2-cycles in the graph", 2, two_cycle_count},
+    {"3cycles", "the number of directed 3-cycles in the graph", 5, three_cycle_count},
+    {"girth", "the length of a shortest directed cycle (0 if there is none)", 5, girth},
+    {"components", "the number of strong components of the graph", 5, strong_component_count},
+    {"diameter", "the largest directed distance (-1 if the graph is not strongly connected)", 10, diameter},
+    {"z6", "1 if the graph contains a copy of Z6", 10, z6_property},
+    {"z6count", "the number of copies of Z6 in the graph", 10, z6_count},
+    {"ham", "1 if the graph is hamiltonian", 100, is_hamiltonian},
+    {"hypoham", "1 if the graph is hypohamiltonian", 1000, is_hypohamiltonian},
+    {"hypotrace", "1 if the graph is hypotraceable", 1000, is_hypotraceable},
+    {"hamcycles", "the number of hamiltonian cycles in the graph", 1000, hamiltonian_cycle_count},
+    {"suitable3", "1 if the graph has a suitable 3-cycle", 10000, has_suitable_3_cycle}
+};
+
+#define INVARIANT_COUNT (sizeof(invariants)/sizeof(INVARIANT))
+
+const INVARIANT *find_invariant(const char *name){
+    int i;
+    for(i = 0; i < INVARIANT_COUNT; i++){
+        if(strcmp(invariants[i].name, name)==0){
+            return invariants + i;
+        }
+    }
+    return NULL;
+}
+
+void list_invariants(FILE *f){
+    int i;
+    for(i = 0; i < INVARIANT_COUNT; i++){
+        fprintf(f, " * \033[1m%s\033[0m: %s\n", invariants[i].name, invariants[i].description);
+    }
+}
+
@@ -0,0 +1,77 @@
+/*
+ * File:   directed_invariants.h
+ * Author: nvcleemp
+ *
+ * Created on October 18, 2026
+ */
+
+#ifndef DIRECTED_INVARIANTS_H
+#define	DIRECTED_INVARIANTS_H
+
+#include <stdio.h>
+#include "directed_base.h"
+
+/* The invariants that can be computed by directed_invariant and used in the
+ * expressions of directed_filter. A property is an invariant with value 1 if
+ * the graph has the property and 0 otherwise.
+ */
+
+typedef int (*INVARIANT_FUNCTION)(GRAPH graph, DEGREES out, DEGREES in);
+
+typedef struct {
+    const char *name;
+    const char *description;
+    //a rough estimate of the relative cost: cheaper invariants are evaluated first
+    int cost;
+    INVARIANT_FUNCTION compute;
+} INVARIANT;
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+int arc_count(GRAPH graph, DEGREES out, DEGREES in);
+int sink_count(GRAPH graph, DEGREES out, DEGREES in);
+int source_count(GRAPH graph, DEGREES out, DEGREES in);
+int minimum_out_degree(GRAPH graph, DEGREES out, DEGREES in);
+int minimum_in_degree(GRAPH graph, DEGREES out, DEGREES in);
+int two_cycle_count(GRAPH graph, DEGREES out, DEGREES in);
+int three_cycle_count(GRAPH graph, DEGREES out, DEGREES in);
+
+/**
+ * Returns the length of a shortest directed cycle, or 0 if the graph is
+ * acyclic.
+ */
+int girth(GRAPH graph, DEGREES out, DEGREES in);
+
+/**
+ * Returns the largest directed distance between two vertices, or -1 if the
+ * graph is not strongly connected.
+ */
+int diameter(GRAPH graph, DEGREES out, DEGREES in);
+
+int strong_component_count(GRAPH graph, DEGREES out, DEGREES in);
+
+/**
+ * Returns the number of directed hamiltonian cycles, or INT_MAX if there are
+ * at least that many.
+ */
+int hamiltonian_cycle_count(GRAPH graph, DEGREES out, DEGREES in);
+
+/**
+ * Returns the invariant with the given name, or NULL if there is no such
+ * invariant.
+ */
+const INVARIANT *find_invariant(const char *name);
+
+/**
+ * Prints the name and description of each invariant.
+ */
+void list_invariants(FILE *f);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* DIRECTED_INVARIANTS_H */
+
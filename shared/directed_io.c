@@ -6,226 +6,1715 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "directed_io.h"
+#include "directed_compress.h"
+
+//================= INPUT BUFFER ====================
+
+/* Graphs are decoded directly from an input buffer. Regular files are mapped
+ * into memory. Other input (e.g. pipes) is read in large blocks. This avoids
+ * reading the input one character at a time through stdio. Compressed input
+ * is recognised by its first bytes and decompressed into the blocks.
+ */
+
+#define INPUT_BLOCK_SIZE (1 << 20)
+
+typedef struct _input_buffer {
+    FILE *file;
+    int fd;
+    
+    unsigned char *data;
+    off_t base; //the offset in the file of the first byte in data
+    size_t length; //the number of valid bytes in data
+    size_t position; //the position of the next unread byte
+    size_t capacity;
+    
+    boolean mapped;
+    boolean eof;
+    
+    DECOMPRESSOR *decompressor;
+    
+    //the raw bytes of the last graph that was read
+    size_t record_start;
+    size_t record_length;
+    
+    //the header of the input if it is a bitset container
+    boolean has_bitset_header;
+    unsigned char bitset_header[BITSET_HEADER_SIZE];
+    
+    //the input starts with the optional digraph6 header
+    boolean has_digraph6_header;
+} INPUT_BUFFER;
+
+static INPUT_BUFFER input = {NULL, -1, NULL, 0, 0, 0, 0, FALSE, FALSE, NULL, 0, 0, FALSE, {0}, FALSE};
+
+static void settle_all_runs();
+
+static void release_input(){
+    if(input.file == NULL) return;
+    
+    //pending output may still point into the mapped input
+    settle_all_runs();
+    
+    if(input.mapped){
+        munmap(input.data, input.capacity);
+    } else {
+        free(input.data);
+    }
+    if(input.decompressor != NULL){
+        free_decompressor(input.decompressor);
+        input.decompressor = NULL;
+    }
+    input.file = NULL;
+    input.data = NULL;
+}
+
+static void open_input(FILE *f){
+    struct stat st;
+    off_t offset;
+    unsigned char magic[4];
+    size_t magic_length = 0;
+    boolean regular;
+    COMPRESSION compression;
+    
+    release_input();
+    
+    input.file = f;
+    input.fd = fileno(f);
+    input.length = input.position = input.capacity = 0;
+    input.record_start = input.record_length = 0;
+    input.has_bitset_header = FALSE;
+    input.has_digraph6_header = FALSE;
+    input.mapped = FALSE;
+    input.eof = FALSE;
+    
+    offset = lseek(input.fd, 0, SEEK_CUR);
+    input.base = offset < 0 ? 0 : offset;
+    
+    regular = fstat(input.fd, &st) == 0 && S_ISREG(st.st_mode) && offset >= 0;
+    
+    //look at the first bytes to recognise compressed input
+    if(regular){
+        ssize_t count = pread(input.fd, magic, sizeof(magic), offset);
+        compression = detect_compression(magic, count < 0 ? 0 : count);
+    } else {
+        while(magic_length < sizeof(magic)){
+            ssize_t count = read(input.fd, magic + magic_length, sizeof(magic) - magic_length);
+            if(count < 0 && errno == EINTR) continue;
+            if(count <= 0) break;
+            magic_length += count;
+        }
+        compression = detect_compression(magic, magic_length);
+    }
+    
+    if(regular && compression == COMPRESSION_NONE && st.st_size > 0){
+        void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, input.fd, 0);
+        if(map != MAP_FAILED){
+            madvise(map, st.st_size, MADV_SEQUENTIAL);
+            input.data = (unsigned char *) map;
+            input.capacity = input.length = st.st_size;
+            input.base = 0;
+            input.position = offset;
+            input.mapped = TRUE;
+            input.eof = TRUE;
+            return;
+        }
+    }
+    
+    //fall back to large reads
+    posix_fadvise(input.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    input.data = (unsigned char *) malloc(INPUT_BLOCK_SIZE);
+    if(input.data == NULL){
+        fprintf(stderr, "Insufficient memory\n");
+        exit(1);
+    }
+    input.capacity = INPUT_BLOCK_SIZE;
+    
+    if(compression != COMPRESSION_NONE){
+        input.decompressor = new_decompressor(compression, input.fd, magic, magic_length);
+        input.base = 0;
+    } else {
+        //the bytes that were already read
+        memcpy(input.data, magic, magic_length);
+        input.length = magic_length;
+    }
+}
+
+/**
+ * Makes sure that at least the given number of bytes are available after the
+ * current position in the input buffer, unless the end of the input is reached.
+ * 
+ * @return the number of bytes available after the current position
+ */
+static size_t fill_input(FILE *f, size_t needed){
+    if(input.file != f){
+        open_input(f);
+    }
+    
+    if(input.length - input.position >= needed || input.eof){
+        return input.length - input.position;
+    }
+    
+    //move the remaining bytes to the front
+    memmove(input.data, input.data + input.position, input.length - input.position);
+    input.base += input.position;
+    input.length -= input.position;
+    input.position = 0;
+    
+    while(input.length < needed && !input.eof){
+        ssize_t count;
+        if(input.decompressor != NULL){
+            count = read_decompressed(input.decompressor, input.data + input.length, input.capacity - input.length);
+        } else {
+            count = read(input.fd, input.data + input.length, input.capacity - input.length);
+        }
+        if(count < 0){
+            if(errno == EINTR) continue;
+            fprintf(stderr, "Error while reading input -- exiting!\n");
+            exit(1);
+        } else if(count == 0){
+            input.eof = TRUE;
+        } else {
+            input.length += count;
+        }
+    }
+    
+    return input.length;
+}
+
+//================= GRAPH SELECTION ====================
+
+/* The reading functions can be restricted to a range of graph numbers or to
+ * a list of graph numbers. Graphs that are not selected are skipped without
+ * decoding them. If an index of the input is given and the input is mapped,
+ * the readers jump directly to the next selected graph.
+ */
+
+static struct {
+    boolean active;
+    
+    unsigned long long int first;
+    unsigned long long int last;
+    
+    unsigned long long int *ids; //sorted and without duplicates
+    size_t id_count;
+    size_t next_id;
+    
+    const unsigned long long int *offsets;
+    unsigned long long int offset_count;
+    unsigned int index_format;
+    unsigned long long int indexed_size; //the size of the file that was indexed
+    boolean index_unused; //the input is not a regular uncompressed file
+} selection = {FALSE, 1, ULLONG_MAX, NULL, 0, 0, NULL, 0, 0, 0, FALSE};
+
+//the number of the last graph that was read (starting from 1)
+static unsigned long long int graph_number = 0;
+
+unsigned long long int input_graph_number(){
+    return graph_number;
+}
+
+unsigned long long int input_record_offset(){
+    return input.base + input.record_start;
+}
+
+unsigned long long int input_end_offset(){
+    return input.base + input.length;
+}
+
+void select_graph_range(const char *range){
+    unsigned long long int first, last;
+    char *end;
+    
+    first = strtoull(range, &end, 10);
+    if(*end != ':'){
+        fprintf(stderr, "Illegal range %s (expected first:last) -- exiting!\n", range);
+        exit(1);
+    }
+    if(end[1] == '\0'){
+        last = ULLONG_MAX;
+        end++;
+    } else {
+        last = strtoull(end + 1, &end, 10);
+    }
+    if(*end != '\0' || first == 0 || last < first){
+        fprintf(stderr, "Illegal range %s (expected first:last) -- exiting!\n", range);
+        exit(1);
+    }
+    selection.active = TRUE;
+    selection.first = first;
+    selection.last = last;
+}
+
+static int compare_ids(const void *a, const void *b){
+    unsigned long long int x = *(const unsigned long long int *)a;
+    unsigned long long int y = *(const unsigned long long int *)b;
+    return (x > y) - (x < y);
+}
+
+void select_graph_ids(const char *filename){
+    FILE *f = fopen(filename, "r");
+    unsigned long long int id;
+    size_t capacity = 1024, i, j;
+    
+    if(f == NULL){
+        fprintf(stderr, "Could not open %s -- exiting!\n", filename);
+        exit(1);
+    }
+    free(selection.ids);
+    selection.ids = (unsigned long long int *) malloc(capacity * sizeof(unsigned long long int));
+    selection.id_count = 0;
+    while(selection.ids != NULL && fscanf(f, "%llu", &id) == 1){
+        if(id == 0){
+            fprintf(stderr, "Graph numbers start from 1 -- exiting!\n");
+            exit(1);
+        }
+        if(selection.id_count == capacity){
+            capacity *= 2;
+            selection.ids = (unsigned long long int *) realloc(selection.ids, capacity * sizeof(unsigned long long int));
+            if(selection.ids == NULL) break;
+        }
+        selection.ids[selection.id_count++] = id;
+    }
+    if(selection.ids == NULL){
+        fprintf(stderr, "Insufficient memory\n");
+        exit(1);
+    }
+    if(!feof(f)){
+        fprintf(stderr, "Illegal graph number in %s -- exiting!\n", filename);
+        exit(1);
+    }
+    fclose(f);
+    
+    //the graphs are read in the order of the input
+    qsort(selection.ids, selection.id_count, sizeof(unsigned long long int), compare_ids);
+    for(i = j = 0; i < selection.id_count; i++){
+        if(j == 0 || selection.ids[j-1] != selection.ids[i]){
+            selection.ids[j++] = selection.ids[i];
+        }
+    }
+    selection.id_count = j;
+    selection.next_id = 0;
+    selection.active = TRUE;
+}
+
+void use_graph_index(const char *filename){
+    int fd = open(filename, O_RDONLY);
+    struct stat st;
+    const unsigned char *map;
+    
+    if(fd < 0 || fstat(fd, &st) != 0){
+        fprintf(stderr, "Could not open %s -- exiting!\n", filename);
+        exit(1);
+    }
+    if(st.st_size < GRAPH_INDEX_HEADER_SIZE || (st.st_size - GRAPH_INDEX_HEADER_SIZE) % 8){
+        fprintf(stderr, "%s is not a graph index -- exiting!\n", filename);
+        exit(1);
+    }
+    map = (const unsigned char *) mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED || memcmp(map, GRAPH_INDEX_MAGIC, 8) != 0){
+        fprintf(stderr, "%s is not a graph index -- exiting!\n", filename);
+        exit(1);
+    }
+    if(*(const unsigned int *)(map + 8) != GRAPH_INDEX_VERSION){
+        fprintf(stderr, "Unsupported version of graph index %s -- exiting!\n", filename);
+        exit(1);
+    }
+    selection.index_format = *(const unsigned int *)(map + 12);
+    selection.indexed_size = *(const unsigned long long int *)(map + 16);
+    selection.offsets = (const unsigned long long int *)(map + GRAPH_INDEX_HEADER_SIZE);
+    selection.offset_count = (st.st_size - GRAPH_INDEX_HEADER_SIZE) / 8;
+    if(*(const unsigned long long int *)(map + 24) != selection.offset_count){
+        fprintf(stderr, "Graph index %s is truncated -- exiting!\n", filename);
+        exit(1);
+    }
+}
+
+void handle_shared_io_option(int option, const char *argument){
+    switch(option){
+        case COMPRESS_OPTION:
+            if(!set_output_compression(argument)){
+                fprintf(stderr, "Unknown or unsupported compression %s -- exiting!\n", argument);
+                exit(1);
+            }
+            break;
+        case COMPRESS_THREADS_OPTION:
+            set_compression_threads(atoi(argument));
+            break;
+        case SELECT_RANGE_OPTION:
+            select_graph_range(argument);
+            break;
+        case SELECT_IDS_OPTION:
+            select_graph_ids(argument);
+            break;
+        case SELECT_INDEX_OPTION:
+            use_graph_index(argument);
+            break;
+    }
+}
+
+void help_shared_io_options(FILE *f){
+    fprintf(f, "    --range first:last\n");
+    fprintf(f, "       Only reads the graphs with numbers first up to last (the first graph\n");
+    fprintf(f, "       has number 1). If last is omitted, all graphs from first on are read.\n");
+    fprintf(f, "    --ids file\n");
+    fprintf(f, "       Only reads the graphs whose numbers are listed in the file. The graphs\n");
+    fprintf(f, "       are read in the order in which they appear in the input.\n");
+    fprintf(f, "    --index file\n");
+    fprintf(f, "       Uses an index created by directed_index to jump directly to the selected\n");
+    fprintf(f, "       graphs instead of skipping the graphs before them. Only regular files\n");
+    fprintf(f, "       without compression can be accessed in this way.\n");
+    fprintf(f, "    --compress method[:level]\n");
+    fprintf(f, "       Compresses the graphs that are written with gzip or zstd (if the\n");
+    fprintf(f, "       program was compiled with support for it). Compressed input is always\n");
+    fprintf(f, "       recognised automatically.\n");
+    fprintf(f, "    --compress-threads #\n");
+    fprintf(f, "       The number of threads that compress output (default: one per processor).\n");
+}
+
+/**
+ * Moves the input to the next selected graph. Graphs that are skipped are
+ * only scanned with the given function.
+ * 
+ * @return FALSE if there are no more selected graphs
+ */
+static boolean move_to_selected_graph(FILE *f, unsigned int format, boolean (*skip_record)(FILE *)){
+    unsigned long long int next;
+    
+    if(selection.ids != NULL){
+        while(selection.next_id < selection.id_count && selection.ids[selection.next_id] <= graph_number){
+            selection.next_id++;
+        }
+        if(selection.next_id == selection.id_count){
+            return FALSE;
+        }
+        next = selection.ids[selection.next_id];
+    } else {
+        next = graph_number + 1;
+    }
+    if(next < selection.first){
+        next = selection.first;
+    }
+    if(next > selection.last){
+        return FALSE;
+    }
+    
+    if(next == graph_number + 1){
+        return TRUE;
+    }
+    
+    if(selection.offsets != NULL){
+        if(selection.index_format != format){
+            fprintf(stderr, "The index was created for another format -- exiting!\n");
+            exit(1);
+        }
+        fill_input(f, 0);
+        if(input.mapped){
+            if(input.length != selection.indexed_size){
+                fprintf(stderr, "The index was created for another file -- exiting!\n");
+                exit(1);
+            }
+            if(next > selection.offset_count){
+                return FALSE;
+            }
+            if(selection.offsets[next - 1] > input.length){
+                fprintf(stderr, "The index does not match the input -- exiting!\n");
+                exit(1);
+            }
+            input.position = selection.offsets[next - 1];
+            graph_number = next - 1;
+            return TRUE;
+        } else if(!selection.index_unused){
+            fprintf(stderr, "The index can only be used for uncompressed regular files; the graphs are skipped instead.\n");
+            selection.index_unused = TRUE;
+        }
+    }
+    
+    while(graph_number + 1 < next){
+        if(!skip_record(f)){
+            return FALSE;
+        }
+        graph_number++;
+    }
+    return TRUE;
+}
 
 //================= I/O METHODS ====================
 
-void decode_watercluster_format(unsigned char* code, int length, GRAPH graph, DEGREES out, DEGREES in) {
-    int i, j, current_vertex;
+/**
+ * Returns TRUE if the input is a bitset container. The watercluster and
+ * digraph6 readers hand these over to the bitset reader, so all tools can
+ * read bitset containers without extra options.
+ */
+static boolean is_bitset_input(FILE *f){
+    size_t available = fill_input(f, BITSET_HEADER_SIZE);
+    
+    return input.has_bitset_header ||
+            (available >= 8 && memcmp(input.data + input.position, BITSET_MAGIC, 8) == 0);
+}
+
+/**
+ * Decodes a graph in watercluster format.
+ * 
+ * @param code the start of the code
+ * @param available the number of bytes available starting at code
+ * @return the length of the code, or 0 if the code is incomplete
+ */
+int decode_watercluster_format(unsigned char* code, size_t available, GRAPH graph, DEGREES out, DEGREES in) {
+    int i, current_vertex;
     unsigned char vertex_count;
 
     graph[0][0] = vertex_count = code[0];
+    
+    if (vertex_count > MAXN) {
+        fprintf(stderr, "Constant N too small %d > %d \n", vertex_count, MAXN);
+        exit(1);
+    }
 
     //mark all vertices as having degree 0
     for (i = 1; i <= vertex_count; i++) {
         out[i] = 0;
         in[i] = 0;
-        for (j = 0; j <= MAXVAL; j++) {
-            graph[i][j] = EMPTY;
-        }
-    }
-    //clear first row
-    for (j = 1; j <= MAXVAL; j++) {
-        graph[0][j] = 0;
     }
 
     //go through code and add edges
     current_vertex = 1;
+    i = 1;
 
-    for (i = 1; i < length; i++) {
-        if (code[i] == 0) {
+    while (current_vertex <= vertex_count) {
+        if (i == available) {
+            return 0;
+        }
+        unsigned char neighbour = code[i++];
+        if (neighbour == 0) {
             current_vertex++;
         } else {
-            graph[current_vertex][out[current_vertex]] = code[i];
-            out[current_vertex]++;
-            in[code[i]]++;
-            if (out[current_vertex] > MAXVAL || in[code[i]] > MAXVAL) {
+            if (neighbour > vertex_count) {
+                fprintf(stderr, "Illegal vertex %d in graph with %d vertices -- exiting!\n", neighbour, vertex_count);
+                exit(1);
+            }
+            if (out[current_vertex] == MAXVAL || in[neighbour] == MAXVAL) {
                 fprintf(stderr, "MAXVAL too small (%d)!\n", MAXVAL);
                 exit(0);
             }
+            graph[current_vertex][out[current_vertex]] = neighbour;
+            out[current_vertex]++;
+            in[neighbour]++;
         }
     }
+    
+    return i;
 }
 
 /**
- * 
- * @param code
- * @param length
- * @param file
- * @return returns 1 if a code was read and 0 otherwise. Exits in case of error.
+ * Skips a graph in watercluster format without decoding it.
  */
-int read_watercluster_format(unsigned char code[], int *length, FILE *file) {
-    unsigned char c;
-    int pos, zero_count;
-
-    if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
-        //nothing left in file
-        return (0);
-    }
-
-    if (c > MAXN) {
-        fprintf(stderr, "Constant N too small %d > %d \n", code[0], MAXN);
-        exit(1);
+static boolean skip_watercluster_record(FILE *f){
+    size_t available = fill_input(f, MAXCODELENGTH);
+    unsigned char *code = input.data + input.position;
+    size_t i = 1;
+    int zeros = 0;
+    
+    if (available == 0) {
+        return FALSE;
     }
-    code[0] = c;
-    zero_count = 0;
-    pos = 1;
     
-    while (zero_count < code[0]) {
-        code[pos] = (unsigned char) getc(file);
-        if (code[pos] == 0) zero_count++;
-        pos++;
+    while (zeros < code[0]) {
+        unsigned char *zero;
+        if (i >= available || (zero = memchr(code + i, 0, available - i)) == NULL) {
+            fprintf(stderr, "Incomplete graph at the end of the input -- exiting!\n");
+            exit(1);
+        }
+        i = zero - code + 1;
+        zeros++;
     }
-
-    *length = pos;
-    return (1);
+    input.position += i;
+    return TRUE;
 }
 
-//array to store code in watercluster format
-unsigned char code[MAXCODELENGTH];
-
 boolean read_graph_from_watercluster_file(FILE *f, GRAPH graph, DEGREES out, DEGREES in){
+    size_t available;
     int length;
-    if (read_watercluster_format(code, &length, f)) {
-        decode_watercluster_format(code, length, graph, out, in);
-        return TRUE;
-    } else {
+    
+    if (is_bitset_input(f)) {
+        return read_graph_from_bitset_file(f, graph, out, in);
+    }
+    
+    if (selection.active && !move_to_selected_graph(f, GRAPH_INDEX_WATERCLUSTER, skip_watercluster_record)) {
+        return FALSE;
+    }
+    
+    available = fill_input(f, MAXCODELENGTH);
+    if (available == 0) {
+        //nothing left in file
         return FALSE;
     }
+    
+    length = decode_watercluster_format(input.data + input.position, available, graph, out, in);
+    if (length == 0) {
+        fprintf(stderr, "Incomplete graph at the end of the input -- exiting!\n");
+        exit(1);
+    }
+    input.record_start = input.position;
+    input.record_length = length;
+    input.position += length;
+    graph_number++;
+    
+    return TRUE;
 }
 
-void write_watercluster_format(GRAPH graph, DEGREES out, FILE *f){
+/**
+ * Writes the watercluster code of the graph to the given array, which should
+ * have room for at least MAXCODELENGTH characters.
+ * 
+ * @return the length of the code
+ */
+int encode_watercluster_format(GRAPH graph, DEGREES out, unsigned char code[]){
     int i, j;
+    int length = 0;
     
     int vertex_count = graph[0][0];
     
-    //write the number of vertices
-    fputc(vertex_count, f);
-    
+    code[length++] = vertex_count;
     for(i=1; i<=vertex_count; i++){
         for(j=0; j<out[i]; j++){
-            fputc(graph[i][j], f);
+            code[length++] = graph[i][j];
         }
-        fputc(0, f);
+        code[length++] = 0;
     }
+    
+    return length;
 }
 
-#define D6BODYLEN(n) \
-   ((n)*(size_t)((n)/6) + (((n)*(size_t)((n)%6)+5)/6))
-#define D6LEN(n) (1 + SIZELEN(n) + D6BODYLEN(n))
-  /* exact digraph6 string length excluding \n\0 
-     This twisted expression works up to n=160529 in 32-bit arithmetic
-     and for larger n if size_t has 64 bits.  */
-#define FLOCKFILE(f) flockfile(f)
-#define FUNLOCKFILE(f) funlockfile(f)
-#define GETC(f) getc_unlocked(f)
-
-int available_line_length = 0;
-char *line;
-     
-/* read a line with error checking */
-/* includes \n (if present) and \0.  Immediate EOF causes NULL return. */
-boolean nvcleemp_getline(FILE *f){
-    int c;
-    long i;
-    
-    if(available_line_length==0){
-        line = malloc(5000*sizeof(char));
-        available_line_length = 5000;
-    }
-    
-    if(line==NULL){
-        fprintf(stderr, "Insufficient memory\n");
-        exit(1);
-    }
+//================= OUTPUT BUFFERS ====================
 
-    FLOCKFILE(f);
-    i = 0;
-    while ((c = GETC(f)) != EOF && c != '\n'){
-        if (i == available_line_length-3){
-            line = realloc(line, (3*(available_line_length/2)+10000)*sizeof(char));
-            if(line==NULL){
-                fprintf(stderr, "Insufficient memory\n");
-                exit(1);
-            }
-        }
-        line[i] = (char)c;
-        i++;
+/* Graphs are encoded directly into an output buffer per file. These buffers
+ * are written in large blocks with write() instead of one fputc per byte.
+ * All buffers are flushed when the program exits.
+ * 
+ * Raw input records from a mapped input file are not copied right away.
+ * Consecutive records are collected in a run that points into the mapping.
+ * Long runs are written directly from the mapping; short runs are copied into
+ * the buffer once the run is interrupted.
+ */
+
+#define RUN_COPY_LIMIT (1 << 16)
+
+typedef struct _output_buffer {
+    FILE *file;
+    unsigned char *data;
+    size_t length;
+    
+    //bytes of the mapped input that should be written after the buffered data
+    unsigned char *run;
+    size_t run_length;
+    
+    //whether the header of the file format was written
+    boolean header_written;
+    
+    COMPRESSOR *compressor;
+} OUTPUT_BUFFER;
+
+static OUTPUT_BUFFER *outputs = NULL;
+static int output_count = 0;
+static int output_capacity = 0;
+static int last_output = -1;
+
+static void flush_output_buffer(OUTPUT_BUFFER *ob){
+    if(ob->length == 0 && ob->run_length == 0) return;
+    
+    if(ob->compressor != NULL){
+        //runs are not used for compressed output
+        compress_block(ob->compressor, &ob->data, ob->length);
+        ob->length = 0;
+        return;
     }
-    FUNLOCKFILE(f);
     
-    if(i == 0 && c == EOF) return FALSE;
+    //make sure anything written through stdio comes first
+    fflush(ob->file);
+    write_fully(fileno(ob->file), ob->data, ob->length);
+    ob->length = 0;
+    write_fully(fileno(ob->file), ob->run, ob->run_length);
+    ob->run_length = 0;
+}
 
-    if (c == '\n') line[i++] = '\n';
-    line[i] = '\0';
-    return TRUE;
+/**
+ * Makes sure that the buffer no longer refers to a run in the input: the run
+ * is copied into the buffer if it is short, and written out otherwise.
+ */
+static void settle_run(OUTPUT_BUFFER *ob){
+    if(ob->run_length == 0) return;
+    
+    if(ob->run_length > RUN_COPY_LIMIT){
+        flush_output_buffer(ob);
+        return;
+    }
+    if(ob->length + ob->run_length > OUTPUT_BLOCK_SIZE){
+        fflush(ob->file);
+        write_fully(fileno(ob->file), ob->data, ob->length);
+        ob->length = 0;
+    }
+    memcpy(ob->data + ob->length, ob->run, ob->run_length);
+    ob->length += ob->run_length;
+    ob->run_length = 0;
 }
 
+static void settle_all_runs(){
+    int i;
+    for(i = 0; i < output_count; i++){
+        settle_run(outputs + i);
+    }
+}
 
-boolean decode_digraph6(GRAPH graph, DEGREES out, DEGREES in){
-    int pos;
-    int i, j;
-    
-    if( line[0]==0 ) return FALSE;
+/**
+ * Flushes the output buffer and waits until all compressed blocks are written.
+ */
+static void finish_output_buffer(OUTPUT_BUFFER *ob){
+    flush_output_buffer(ob);
+    if(ob->compressor != NULL){
+        finish_compressor(ob->compressor);
+    }
+}
+
+static void flush_all_outputs(){
+    int i;
+    for(i = 0; i < output_count; i++){
+        finish_output_buffer(outputs + i);
+    }
+}
+
+static OUTPUT_BUFFER *get_output(FILE *f){
+    int i;
     
-    if( line[0]!='&' ){
-        fprintf(stderr, "Not a digraph6 file\n");
-        exit(1);
+    if(last_output >= 0 && outputs[last_output].file == f){
+        return outputs + last_output;
     }
     
-    if( line[1]==126 ){
-        if( line[2]==126 ){
-            fprintf(stderr, "Graph too large\n");
-            exit(1);
+    for(i = 0; i < output_count; i++){
+        if(outputs[i].file == f){
+            last_output = i;
+            return outputs + i;
         }
-        graph[0][0] = (line[2] - 63) * 4096 + (line[3] - 63) * 64 + (line[4] - 63);
-        pos = 5;
-    } else {
-        graph[0][0] = line[1] - 63;
-        pos = 2;
     }
     
-    //mark all vertices as having degree 0
-    for (i = 1; i <= graph[0][0]; i++) {
-        out[i] = 0;
-        in[i] = 0;
-        for (j = 0; j <= MAXVAL; j++) {
-            graph[i][j] = EMPTY;
+    if(outputs == NULL){
+        atexit(flush_all_outputs);
+    }
+    if(output_count == output_capacity){
+        output_capacity = output_capacity ? 2*output_capacity : 8;
+        outputs = (OUTPUT_BUFFER *) realloc(outputs, output_capacity * sizeof(OUTPUT_BUFFER));
+        if(outputs == NULL){
+            fprintf(stderr, "Insufficient memory\n");
+            exit(1);
         }
     }
-    //clear first row
-    for (j = 1; j <= MAXVAL; j++) {
-        graph[0][j] = 0;
+    outputs[output_count].file = f;
+    outputs[output_count].length = 0;
+    outputs[output_count].run = NULL;
+    outputs[output_count].run_length = 0;
+    outputs[output_count].header_written = FALSE;
+    outputs[output_count].compressor = output_compression() == COMPRESSION_NONE ?
+            NULL : new_compressor(fileno(f), OUTPUT_BLOCK_SIZE);
+    outputs[output_count].data = (unsigned char *) malloc(OUTPUT_BLOCK_SIZE);
+    if(outputs[output_count].data == NULL){
+        fprintf(stderr, "Insufficient memory\n");
+        exit(1);
     }
-    
-    int index0 = 1;
-    int index1 = 1;
-    while (line[pos]!=0) {
-        char k;
-        char number = (char) (line[pos] - 63);
-        pos++;
-        for (k = 1 << 5; k >= 1; k >>= 1) {
-            if ((number & k)) {
-                graph[index1][out[index1]] = index0;
-                out[index1]++;
-                in[index0]++;
-            }
-            index0++;
-            if (index0 == graph[0][0] + 1) {
-                index1++;
-                index0 = 1;
-            }
-        }
+    last_output = output_count++;
+    return outputs + last_output;
+}
+
+/**
+ * Returns a pointer to room for at least length bytes in the output buffer.
+ * The caller adds the number of bytes that were actually used to the length
+ * of the buffer.
+ */
+static unsigned char *reserve_output(OUTPUT_BUFFER *ob, size_t length){
+    settle_run(ob);
+    if(ob->length + length > OUTPUT_BLOCK_SIZE){
+        flush_output_buffer(ob);
     }
+    return ob->data + ob->length;
+}
+
+void write_graph_code(unsigned char *code, size_t length, FILE *f){
+    OUTPUT_BUFFER *ob = get_output(f);
+    
+    if(length > OUTPUT_BLOCK_SIZE && ob->compressor == NULL){
+        //too large to buffer: write it directly
+        flush_output_buffer(ob);
+        fflush(f);
+        write_fully(fileno(f), code, length);
+        return;
+    }
+    while(length > 0){
+        size_t part = length > OUTPUT_BLOCK_SIZE ? OUTPUT_BLOCK_SIZE : length;
+        memcpy(reserve_output(ob, part), code, part);
+        ob->length += part;
+        code += part;
+        length -= part;
+    }
+}
+
+void write_input_graph(GRAPH graph, DEGREES out, FILE *f){
+    OUTPUT_BUFFER *ob = get_output(f);
+    unsigned char *record = input.data + input.record_start;
+    size_t length = input.record_length;
+    
+    if(input.file == NULL || length == 0){
+        //nothing was read yet
+        write_watercluster_format(graph, out, f);
+        return;
+    }
+    
+    if(input.has_bitset_header && !ob->header_written){
+        memcpy(reserve_output(ob, BITSET_HEADER_SIZE), input.bitset_header, BITSET_HEADER_SIZE);
+        ob->length += BITSET_HEADER_SIZE;
+        ob->header_written = TRUE;
+    } else if(input.has_digraph6_header && !ob->header_written){
+        memcpy(reserve_output(ob, sizeof(DIGRAPH6_HEADER) - 1), DIGRAPH6_HEADER, sizeof(DIGRAPH6_HEADER) - 1);
+        ob->length += sizeof(DIGRAPH6_HEADER) - 1;
+        ob->header_written = TRUE;
+    }
+    
+    if(input.mapped && ob->compressor == NULL){
+        if(ob->run_length && ob->run + ob->run_length == record){
+            ob->run_length += length;
+        } else {
+            settle_run(ob);
+            ob->run = record;
+            ob->run_length = length;
+        }
+        return;
+    }
+    
+    //the block buffer is reused by the next read, so the record is copied
+    if(length > OUTPUT_BLOCK_SIZE){
+        write_graph_code(record, length, f);
+        return;
+    }
+    memcpy(reserve_output(ob, length), record, length);
+    ob->length += length;
+}
+
+void flush_graph_output(FILE *f){
+    int i;
+    for(i = 0; i < output_count; i++){
+        if(outputs[i].file == f){
+            finish_output_buffer(outputs + i);
+        }
+    }
+}
+
+void close_graph_output(FILE *f){
+    int i;
+    for(i = 0; i < output_count; i++){
+        if(outputs[i].file == f){
+            finish_output_buffer(outputs + i);
+            if(outputs[i].compressor != NULL){
+                free_compressor(outputs[i].compressor);
+            }
+            free(outputs[i].data);
+            outputs[i] = outputs[--output_count];
+            break;
+        }
+    }
+    last_output = -1;
+    fclose(f);
+}
+
+void write_watercluster_format(GRAPH graph, DEGREES out, FILE *f){
+    OUTPUT_BUFFER *ob = get_output(f);
+    
+    ob->length += encode_watercluster_format(graph, out, reserve_output(ob, MAXCODELENGTH));
+}
+
+//================= DIGRAPH6 ====================
+
+#define D6BODYLEN(n) \
+   ((n)*(size_t)((n)/6) + (((n)*(size_t)((n)%6)+5)/6))
+  /* exact length of the body of a digraph6 string */
+
+#define SWAR_ONES 0x0101010101010101ULL
+#define SWAR_HIGH 0x8080808080808080ULL
+
+/**
+ * Reverses the order of the lowest width bits of x.
+ */
+static inline BITSET reverse_bits(BITSET x, int width){
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    x = __builtin_bswap64(x);
+    return x >> (64 - width);
+}
+
+/**
+ * Packs the 6-bit values of eight digraph6 characters into six bytes of a big
+ * endian bit stream. Returns FALSE if one of the characters is not valid.
+ */
+static inline boolean pack_digraph6_block(const unsigned char *chars, unsigned char *bits){
+    unsigned long long int x;
+    
+    memcpy(&x, chars, 8);
+    //all characters should be in the range 63..126
+    if((x & SWAR_HIGH) || ((x + 65*SWAR_ONES) & ~(x + SWAR_ONES) & SWAR_HIGH) != SWAR_HIGH){
+        return FALSE;
+    }
+    x -= 63*SWAR_ONES;
+    
+    //combine pairs of characters into 12 bits, then pairs of those into 24 bits
+    x = ((x & 0x003F003F003F003FULL) << 6) | ((x >> 8) & 0x003F003F003F003FULL);
+    x = ((x & 0x00000FFF00000FFFULL) << 12) | ((x >> 16) & 0x00000FFF00000FFFULL);
+    x = ((x & 0x0000000000FFFFFFULL) << 24) | (x >> 32);
+    
+    //store the 48 bits in big endian order
+    x = __builtin_bswap64(x << 16);
+    memcpy(bits, &x, 6);
+    return TRUE;
+}
+
+/**
+ * Decodes a graph in digraph6 format. The body is first packed into a bit
+ * stream eight characters at a time. Each row of the adjacency matrix is then
+ * extracted as a bitmask, from which the adjacency list is built.
+ * 
+ * @param code the start of the code (the '&' character)
+ * @param length the length of the code without the newline
+ * @return TRUE if the code was decoded and FALSE if it is not valid
+ */
+boolean decode_digraph6(const unsigned char *code, size_t length, GRAPH graph, DEGREES out, DEGREES in){
+    unsigned char chars[D6BODYLEN(MAXN) + 8];
+    unsigned char bits[(D6BODYLEN(MAXN) + 8) / 8 * 6 + 8];
+    size_t body_length, i;
+    int order, v;
+    
+    if(length < 2 || code[0] != '&'){
+        return FALSE;
+    }
+    if(code[1] == 126){
+        fprintf(stderr, "Graph too large\n");
+        exit(1);
+    }
+    order = code[1] - 63;
+    if(order < 0 || order > MAXN){
+        fprintf(stderr, "Constant N too small %d > %d \n", order, MAXN);
+        exit(1);
+    }
+    body_length = D6BODYLEN(order);
+    if(length != 2 + body_length){
+        return FALSE;
+    }
+    
+    //pad the body with zero bits to a multiple of eight characters
+    memcpy(chars, code + 2, body_length);
+    for(i = body_length; i % 8; i++){
+        chars[i] = 63;
+    }
+    for(i = 0; 8*i < body_length; i++){
+        if(!pack_digraph6_block(chars + 8*i, bits + 6*i)){
+            return FALSE;
+        }
+    }
+    memset(bits + 6*i, 0, 8);
+    
+    graph[0][0] = order;
+    for(v = 1; v <= order; v++){
+        out[v] = 0;
+        in[v] = 0;
+    }
+    
+    for(v = 1; v <= order; v++){
+        size_t offset = (size_t)(v - 1) * order;
+        unsigned long long int window;
+        BITSET row;
+        
+        memcpy(&window, bits + offset / 8, 8);
+        window = __builtin_bswap64(window) << (offset % 8);
+        //the first bit of the row is the arc to vertex 1
+        row = order ? reverse_bits(window >> (64 - order), order) << 1 : 0;
+        
+        while(row){
+            int w = __builtin_ctzll(row);
+            row &= row - 1;
+            graph[v][out[v]++] = w;
+            in[w]++;
+        }
+    }
+    
+    return TRUE;
+}
+
+/**
+ * Makes sure that at least the maximum length of a digraph6 code is available
+ * in the input buffer, and skips the optional header.
+ * 
+ * @return the number of bytes available after the current position
+ */
+static size_t fill_digraph6_input(FILE *f){
+    size_t available = fill_input(f, MAXD6LENGTH + sizeof(DIGRAPH6_HEADER));
+    
+    if(available >= sizeof(DIGRAPH6_HEADER) - 1 &&
+            memcmp(input.data + input.position, DIGRAPH6_HEADER, sizeof(DIGRAPH6_HEADER) - 1) == 0){
+        input.position += sizeof(DIGRAPH6_HEADER) - 1;
+        available -= sizeof(DIGRAPH6_HEADER) - 1;
+        input.has_digraph6_header = TRUE;
+    }
+    return available;
+}
+
+/**
+ * Skips a graph in digraph6 format without decoding it.
+ */
+static boolean skip_digraph6_record(FILE *f){
+    size_t available = fill_digraph6_input(f);
+    unsigned char *code = input.data + input.position;
+    unsigned char *end;
+    
+    if (available == 0) {
+        return FALSE;
+    }
+    end = memchr(code, '\n', available);
+    input.position += end == NULL ? available : (size_t)(end - code) + 1;
+    return TRUE;
 }
 
 boolean read_graph_from_digraph6_file(FILE *f, GRAPH graph, DEGREES out, DEGREES in){
-    if (nvcleemp_getline(f)) {
-        decode_digraph6(graph, out, in);
-        return TRUE;
-    } else {
+    size_t available;
+    unsigned char *code;
+    unsigned char *end;
+    size_t length;
+    
+    if (is_bitset_input(f)) {
+        return read_graph_from_bitset_file(f, graph, out, in);
+    }
+    
+    if (selection.active && !move_to_selected_graph(f, GRAPH_INDEX_DIGRAPH6, skip_digraph6_record)) {
         return FALSE;
     }
+    
+    available = fill_digraph6_input(f);
+    code = input.data + input.position;
+    
+    if (available == 0) {
+        return FALSE;
+    }
+    
+    end = memchr(code, '\n', available);
+    length = end == NULL ? available : (size_t)(end - code);
+    
+    if(length > 0 && code[length - 1] == '\r'){
+        length--;
+    }
+    if(!decode_digraph6(code, length, graph, out, in)){
+        fprintf(stderr, "Not a valid digraph6 code\n");
+        exit(1);
+    }
+    input.record_start = input.position;
+    input.record_length = end == NULL ? available : (size_t)(end - code) + 1;
+    input.position += input.record_length;
+    graph_number++;
+    
+    return TRUE;
+}
+
+/**
+ * Writes the digraph6 code of the graph (including the newline) to the given
+ * array, which should have room for at least MAXD6LENGTH characters.
+ * 
+ * @return the length of the code
+ */
+int encode_digraph6_format(GRAPH graph, DEGREES out, unsigned char code[]){
+    int i, j;
+    int order = graph[0][0];
+    int length = 0;
+    int bit_count = 0;
+    int current = 0;
+    
+    code[length++] = '&';
+    code[length++] = order + 63;
+    
+    for(i = 1; i <= order; i++){
+        BITSET row = 0;
+        for(j = 0; j < out[i]; j++){
+            row |= BIT(graph[i][j]);
+        }
+        for(j = 1; j <= order; j++){
+            current = (current << 1) | ((row >> j) & 1);
+            bit_count++;
+            if(bit_count == 6){
+                code[length++] = current + 63;
+                current = bit_count = 0;
+            }
+        }
+    }
+    if(bit_count){
+        code[length++] = (current << (6 - bit_count)) + 63;
+    }
+    code[length++] = '\n';
+    
+    return length;
+}
+
+void write_digraph6_format(GRAPH graph, DEGREES out, FILE *f){
+    OUTPUT_BUFFER *ob = get_output(f);
+    
+    ob->length += encode_digraph6_format(graph, out, reserve_output(ob, MAXD6LENGTH));
+}
+
+//================= BITSET CONTAINER ====================
+
+/* Each record of a bitset container consists of the order followed by
+ * BITSET_ROWS out-masks and optionally BITSET_ROWS in-masks, all 32-bit words.
+ * Bit w-1 of out-mask v-1 is set if there is an arc from v to w. Since every
+ * record has the same size, graphs can be decoded without parsing and files
+ * can be split at any multiple of the record size after the header.
+ */
+
+static boolean bitset_in_masks = FALSE;
+static unsigned int bitset_stride = 0;
+
+void set_bitset_in_masks(boolean in_masks){
+    bitset_in_masks = in_masks;
+}
+
+static void encode_bitset_header(unsigned char header[BITSET_HEADER_SIZE], boolean in_masks){
+    unsigned int fields[6];
+    
+    fields[0] = BITSET_VERSION;
+    fields[1] = BITSET_BYTE_ORDER;
+    fields[2] = in_masks ? BITSET_IN_MASKS : 0;
+    fields[3] = BITSET_ROWS;
+    fields[4] = BITSET_RECORD_SIZE(in_masks);
+    fields[5] = 0;
+    memcpy(header, BITSET_MAGIC, 8);
+    memcpy(header + 8, fields, sizeof(fields));
+}
+
+/**
+ * Checks the header of a bitset container and returns the record size.
+ */
+static unsigned int decode_bitset_header(const unsigned char header[BITSET_HEADER_SIZE]){
+    unsigned int fields[6];
+    
+    memcpy(fields, header + 8, sizeof(fields));
+    if(fields[1] != BITSET_BYTE_ORDER){
+        fprintf(stderr, "Bitset container was written with another byte order -- exiting!\n");
+        exit(1);
+    }
+    if(fields[0] != BITSET_VERSION || fields[3] != BITSET_ROWS ||
+            fields[4] != BITSET_RECORD_SIZE(fields[2] & BITSET_IN_MASKS)){
+        fprintf(stderr, "Unsupported bitset container -- exiting!\n");
+        exit(1);
+    }
+    return fields[4];
+}
+
+/**
+ * Writes the bitset record of the graph to the given array, which should
+ * have room for at least BITSET_RECORD_SIZE(in_masks) characters.
+ * 
+ * @return the length of the record
+ */
+int encode_bitset_format(GRAPH graph, DEGREES out, boolean in_masks, unsigned char record[]){
+    unsigned int words[1 + 2*BITSET_ROWS];
+    int i, j;
+    int order = graph[0][0];
+    
+    if(order > BITSET_ROWS){
+        fprintf(stderr, "Bitset containers can only store graphs up to %d vertices -- exiting!\n", BITSET_ROWS);
+        exit(1);
+    }
+    
+    memset(words, 0, sizeof(words));
+    words[0] = order;
+    for(i = 1; i <= order; i++){
+        for(j = 0; j < out[i]; j++){
+            int w = graph[i][j];
+            words[i] |= 1U << (w - 1);
+            words[1 + BITSET_ROWS + w - 1] |= 1U << (i - 1);
+        }
+    }
+    
+    memcpy(record, words, BITSET_RECORD_SIZE(in_masks));
+    return BITSET_RECORD_SIZE(in_masks);
+}
+
+/**
+ * Decodes a bitset record. The in-degrees are taken from the in-masks when
+ * they are present.
+ */
+void decode_bitset_format(const unsigned char *record, boolean in_masks, GRAPH graph, DEGREES out, DEGREES in){
+    unsigned int words[1 + 2*BITSET_ROWS];
+    int order, v;
+    
+    memcpy(words, record, BITSET_RECORD_SIZE(in_masks));
+    order = words[0];
+    if(order > MAXN || order > BITSET_ROWS){
+        fprintf(stderr, "Constant N too small %d > %d \n", order, MAXN);
+        exit(1);
+    }
+    
+    graph[0][0] = order;
+    for(v = 1; v <= order; v++){
+        out[v] = 0;
+        in[v] = in_masks ? __builtin_popcount(words[1 + BITSET_ROWS + v - 1]) : 0;
+    }
+    
+    for(v = 1; v <= order; v++){
+        unsigned int row = words[v];
+        
+        if(order < 32 && (row >> order)){
+            fprintf(stderr, "Illegal vertex in graph with %d vertices -- exiting!\n", order);
+            exit(1);
+        }
+        if(__builtin_popcount(row) > MAXVAL){
+            fprintf(stderr, "MAXVAL too small (%d)!\n", MAXVAL);
+            exit(0);
+        }
+        while(row){
+            int w = __builtin_ctz(row) + 1;
+            row &= row - 1;
+            graph[v][out[v]++] = w;
+            if(!in_masks){
+                in[w]++;
+            }
+        }
+    }
+}
+
+/**
+ * Makes sure that a complete record is available in the input buffer, and
+ * reads the header if the input is at the start of a container.
+ * 
+ * @return the number of bytes available after the current position
+ */
+static size_t fill_bitset_input(FILE *f){
+    size_t available;
+    
+    if(input.file != f || !input.has_bitset_header){
+        available = fill_input(f, BITSET_HEADER_SIZE);
+        if(available == 0){
+            return 0;
+        }
+        if(available < BITSET_HEADER_SIZE ||
+                memcmp(input.data + input.position, BITSET_MAGIC, 8) != 0){
+            fprintf(stderr, "Not a bitset container -- exiting!\n");
+            exit(1);
+        }
+        bitset_stride = decode_bitset_header(input.data + input.position);
+        memcpy(input.bitset_header, input.data + input.position, BITSET_HEADER_SIZE);
+        input.has_bitset_header = TRUE;
+        input.position += BITSET_HEADER_SIZE;
+    }
+    
+    available = fill_input(f, bitset_stride);
+    if(available > 0 && available < bitset_stride){
+        fprintf(stderr, "Incomplete graph at the end of the input -- exiting!\n");
+        exit(1);
+    }
+    return available;
+}
+
+static boolean skip_bitset_record(FILE *f){
+    if(fill_bitset_input(f) == 0){
+        return FALSE;
+    }
+    input.position += bitset_stride;
+    return TRUE;
+}
+
+boolean read_graph_from_bitset_file(FILE *f, GRAPH graph, DEGREES out, DEGREES in){
+    if (selection.active && !move_to_selected_graph(f, GRAPH_INDEX_BITSET, skip_bitset_record)) {
+        return FALSE;
+    }
+    
+    if (fill_bitset_input(f) == 0) {
+        return FALSE;
+    }
+    
+    decode_bitset_format(input.data + input.position,
+            bitset_stride == BITSET_RECORD_SIZE(TRUE), graph, out, in);
+    input.record_start = input.position;
+    input.record_length = bitset_stride;
+    input.position += bitset_stride;
+    graph_number++;
+    
+    return TRUE;
+}
+
+void write_bitset_format(GRAPH graph, DEGREES out, FILE *f){
+    OUTPUT_BUFFER *ob = get_output(f);
+    
+    if(!ob->header_written){
+        encode_bitset_header(reserve_output(ob, BITSET_HEADER_SIZE), bitset_in_masks);
+        ob->length += BITSET_HEADER_SIZE;
+        ob->header_written = TRUE;
+    }
+    ob->length += encode_bitset_format(graph, out, bitset_in_masks,
+            reserve_output(ob, BITSET_RECORD_SIZE(bitset_in_masks)));
+}
+
+//================= ADJACENCY LISTS ====================
+
+/* Adjacency lists are text: one line per vertex with the out-neighbours
+ * after a colon, separated by commas, e.g. "1: 2, 3". Graphs are separated by
+ * blank lines. Lines starting with '#' and the "Graph #:" lines written by
+ * directed_show are skipped.
+ */
+
+#define ADJLIST_MAXLENGTH (1 << 16)
+
+static boolean adjlist_zero_based = FALSE;
+
+void set_adjlist_zero_based(boolean zero_based){
+    adjlist_zero_based = zero_based;
+}
+
+/**
+ * Returns the length of the line starting at position (without the newline)
+ * and sets next to the position after the newline.
+ */
+static size_t input_line(size_t position, size_t end, size_t *next){
+    unsigned char *newline = memchr(input.data + position, '\n', end - position);
+    size_t length = newline == NULL ? end - position : (size_t)(newline - input.data) - position;
+    
+    *next = newline == NULL ? end : position + length + 1;
+    return length;
+}
+
+static boolean is_blank_line(const unsigned char *line, size_t length){
+    size_t i;
+    for(i = 0; i < length; i++){
+        if(line[i] != ' ' && line[i] != '\t' && line[i] != '\r') return FALSE;
+    }
+    return TRUE;
+}
+
+static boolean is_skipped_line(const unsigned char *line, size_t length){
+    return (length > 0 && line[0] == '#') || (length >= 5 && memcmp(line, "Graph", 5) == 0);
+}
+
+/**
+ * Decodes the adjacency lists at the current position of the input buffer.
+ * 
+ * @return FALSE if there are no more graphs
+ */
+static boolean decode_adjlist(FILE *f, GRAPH graph, DEGREES out, DEGREES in){
+    size_t end = input.position + fill_input(f, ADJLIST_MAXLENGTH);
+    size_t position = input.position, next, start;
+    int order = 0, v, i;
+    
+    //skip blank lines and comments before the graph
+    while(position < end){
+        size_t length = input_line(position, end, &next);
+        if(!is_blank_line(input.data + position, length) &&
+                !is_skipped_line(input.data + position, length)){
+            break;
+        }
+        position = next;
+    }
+    if(position == end){
+        input.position = end;
+        return FALSE;
+    }
+    start = position;
+    
+    while(position < end){
+        size_t length = input_line(position, end, &next);
+        unsigned char *line = input.data + position;
+        unsigned char *colon;
+        size_t j;
+        
+        if(is_blank_line(line, length)){
+            position = next;
+            break;
+        }
+        if(is_skipped_line(line, length)){
+            position = next;
+            continue;
+        }
+        if(order == MAXN){
+            fprintf(stderr, "Constant N too small %d > %d \n", order + 1, MAXN);
+            exit(1);
+        }
+        order++;
+        out[order] = 0;
+        
+        colon = memchr(line, ':', length);
+        j = colon == NULL ? 0 : (size_t)(colon - line) + 1;
+        while(j < length){
+            int neighbour = 0;
+            boolean digits = FALSE;
+            while(j < length && (line[j] == ' ' || line[j] == ',' || line[j] == '\t' || line[j] == '\r')) j++;
+            while(j < length && line[j] >= '0' && line[j] <= '9'){
+                neighbour = 10*neighbour + line[j++] - '0';
+                if(neighbour > 1000) neighbour = 1000;
+                digits = TRUE;
+            }
+            if(j < length && !digits){
+                fprintf(stderr, "Illegal character in adjacency list -- exiting!\n");
+                exit(1);
+            }
+            if(!digits) break;
+            if(adjlist_zero_based) neighbour++;
+            if(neighbour < 1 || neighbour > MAXN){
+                fprintf(stderr, "Illegal vertex %d in adjacency list -- exiting!\n", neighbour);
+                exit(1);
+            }
+            if(out[order] == MAXVAL){
+                fprintf(stderr, "MAXVAL too small (%d)!\n", MAXVAL);
+                exit(0);
+            }
+            graph[order][out[order]++] = neighbour;
+        }
+        position = next;
+    }
+    if(position == end && !input.eof){
+        fprintf(stderr, "Adjacency lists longer than %d characters -- exiting!\n", ADJLIST_MAXLENGTH);
+        exit(1);
+    }
+    
+    graph[0][0] = order;
+    for(v = 1; v <= order; v++){
+        in[v] = 0;
+    }
+    for(v = 1; v <= order; v++){
+        for(i = 0; i < out[v]; i++){
+            if(graph[v][i] < 1 || graph[v][i] > order){
+                fprintf(stderr, "Illegal vertex %d in graph with %d vertices -- exiting!\n", graph[v][i], order);
+                exit(1);
+            }
+            if(in[graph[v][i]] == MAXVAL){
+                fprintf(stderr, "MAXVAL too small (%d)!\n", MAXVAL);
+                exit(0);
+            }
+            in[graph[v][i]]++;
+        }
+    }
+    
+    input.record_start = start;
+    input.record_length = position - start;
+    input.position = position;
+    return TRUE;
+}
+
+static boolean skip_adjlist_record(FILE *f){
+    GRAPH graph;
+    DEGREES out, in;
+    return decode_adjlist(f, graph, out, in);
+}
+
+boolean read_graph_from_adjlist_file(FILE *f, GRAPH graph, DEGREES out, DEGREES in){
+    if (selection.active && !move_to_selected_graph(f, GRAPH_INDEX_ADJLIST, skip_adjlist_record)) {
+        return FALSE;
+    }
+    if (!decode_adjlist(f, graph, out, in)) {
+        return FALSE;
+    }
+    graph_number++;
+    return TRUE;
+}
+
+//at most 4 characters per vertex number and 3 for the separators
+#define MAXADJLISTLENGTH (MAXN * (7 * (MAXVAL + 1) + 1) + 1)
+
+static int encode_adjlist_format(GRAPH graph, DEGREES out, unsigned char code[]){
+    unsigned char *start = code;
+    int v, i, offset = adjlist_zero_based ? 1 : 0;
+    
+    for(v = 1; v <= graph[0][0]; v++){
+        code += sprintf((char *)code, "%d:", v - offset);
+        for(i = 0; i < out[v]; i++){
+            code += sprintf((char *)code, i ? ", %d" : " %d", graph[v][i] - offset);
+        }
+        *code++ = '\n';
+    }
+    *code++ = '\n';
+    return code - start;
+}
+
+void write_adjlist_format(GRAPH graph, DEGREES out, FILE *f){
+    OUTPUT_BUFFER *ob = get_output(f);
+    
+    ob->length += encode_adjlist_format(graph, out, reserve_output(ob, MAXADJLISTLENGTH));
+}
+
+//================= MULTI_CODE AND PLANAR_CODE ====================
+
+/* Both formats describe undirected graphs. They are read as symmetric
+ * digraphs: every edge becomes a pair of opposite arcs. When a digraph is
+ * written in multi_code, the underlying undirected graph is written.
+ * planar_code needs a combinatorial embedding, so it can only be read.
+ */
+
+#define MULTI_CODE_HEADER ">>multi_code<<"
+#define PLANAR_CODE_HEADER ">>planar_code"
+
+/**
+ * Skips a header like >>multi_code<< or >>planar_code le<< at the current
+ * position of the input buffer.
+ */
+static void skip_format_header(const char *header){
+    size_t available = input.length - input.position;
+    unsigned char *start = input.data + input.position;
+    unsigned char *end;
+    
+    if(available >= strlen(header) && memcmp(start, header, strlen(header)) == 0){
+        end = memchr(start, '<', available > 64 ? 64 : available);
+        if(end == NULL || end + 1 >= start + available || end[1] != '<'){
+            fprintf(stderr, "Illegal header -- exiting!\n");
+            exit(1);
+        }
+        input.position += end + 2 - start;
+    }
+}
+
+static void add_symmetric_arc(GRAPH graph, DEGREES out, DEGREES in, int v, int w){
+    int i;
+    
+    for(i = 0; i < out[v]; i++){
+        if(graph[v][i] == w) return;
+    }
+    if(out[v] == MAXVAL || out[w] == MAXVAL){
+        fprintf(stderr, "MAXVAL too small (%d)!\n", MAXVAL);
+        exit(0);
+    }
+    graph[v][out[v]++] = w;
+    in[w]++;
+    graph[w][out[w]++] = v;
+    in[v]++;
+}
+
+/**
+ * Decodes an undirected code at the current position in the input buffer. In
+ * multi_code vertex v lists its neighbours larger than v and the last vertex
+ * has no list. In planar_code every vertex lists all its neighbours.
+ */
+static boolean decode_undirected_code(FILE *f, boolean planar, GRAPH graph, DEGREES out, DEGREES in){
+    size_t available = fill_input(f, MAXCODELENGTH + 64);
+    unsigned char *code;
+    int order, v, lists;
+    size_t i;
+    
+    //the header cannot be confused with a graph, since '>' is larger than MAXN
+    if(available > 0 && input.data[input.position] == '>'){
+        skip_format_header(planar ? PLANAR_CODE_HEADER : MULTI_CODE_HEADER);
+        available = input.length - input.position;
+    }
+    if(available == 0){
+        return FALSE;
+    }
+    
+    code = input.data + input.position;
+    order = code[0];
+    if(order > MAXN){
+        fprintf(stderr, "Constant N too small %d > %d \n", order, MAXN);
+        exit(1);
+    }
+    graph[0][0] = order;
+    for(v = 1; v <= order; v++){
+        out[v] = in[v] = 0;
+    }
+    
+    lists = planar ? order : order - 1;
+    i = 1;
+    for(v = 1; v <= lists; v++){
+        while(TRUE){
+            if(i >= available){
+                fprintf(stderr, "Incomplete graph at the end of the input -- exiting!\n");
+                exit(1);
+            }
+            unsigned char neighbour = code[i++];
+            if(neighbour == 0) break;
+            if(neighbour > order || neighbour == v){
+                fprintf(stderr, "Illegal vertex %d in graph with %d vertices -- exiting!\n", neighbour, order);
+                exit(1);
+            }
+            add_symmetric_arc(graph, out, in, v, neighbour);
+        }
+    }
+    
+    input.record_start = input.position;
+    input.record_length = i;
+    input.position += i;
+    return TRUE;
+}
+
+static boolean skip_multi_code_record(FILE *f){
+    GRAPH graph;
+    DEGREES out, in;
+    return decode_undirected_code(f, FALSE, graph, out, in);
+}
+
+static boolean skip_planar_code_record(FILE *f){
+    GRAPH graph;
+    DEGREES out, in;
+    return decode_undirected_code(f, TRUE, graph, out, in);
+}
+
+boolean read_graph_from_multi_code_file(FILE *f, GRAPH graph, DEGREES out, DEGREES in){
+    if (selection.active && !move_to_selected_graph(f, GRAPH_INDEX_MULTI_CODE, skip_multi_code_record)) {
+        return FALSE;
+    }
+    if (!decode_undirected_code(f, FALSE, graph, out, in)) {
+        return FALSE;
+    }
+    graph_number++;
+    return TRUE;
+}
+
+boolean read_graph_from_planar_code_file(FILE *f, GRAPH graph, DEGREES out, DEGREES in){
+    if (selection.active && !move_to_selected_graph(f, GRAPH_INDEX_PLANAR_CODE, skip_planar_code_record)) {
+        return FALSE;
+    }
+    if (!decode_undirected_code(f, TRUE, graph, out, in)) {
+        return FALSE;
+    }
+    graph_number++;
+    return TRUE;
+}
+
+/**
+ * Writes the multi_code of the underlying undirected graph to the given
+ * array, which should have room for at least MAXCODELENGTH characters.
+ * 
+ * @return the length of the code
+ */
+int encode_multi_code_format(GRAPH graph, DEGREES out, unsigned char code[]){
+    BITSET neighbours[MAXN + 1];
+    int order = graph[0][0];
+    int length = 0, v, i;
+    
+    for(v = 1; v <= order; v++){
+        neighbours[v] = 0;
+    }
+    for(v = 1; v <= order; v++){
+        for(i = 0; i < out[v]; i++){
+            neighbours[v] |= BIT(graph[v][i]);
+            neighbours[graph[v][i]] |= BIT(v);
+        }
+    }
+    
+    code[length++] = order;
+    for(v = 1; v < order; v++){
+        //only the neighbours larger than v
+        BITSET larger = neighbours[v] & ~(BIT(v + 1) - 1);
+        while(larger){
+            code[length++] = __builtin_ctzll(larger);
+            larger &= larger - 1;
+        }
+        code[length++] = 0;
+    }
+    
+    return length;
+}
+
+void write_multi_code_format(GRAPH graph, DEGREES out, FILE *f){
+    OUTPUT_BUFFER *ob = get_output(f);
+    
+    if(!ob->header_written){
+        memcpy(reserve_output(ob, sizeof(MULTI_CODE_HEADER) - 1), MULTI_CODE_HEADER, sizeof(MULTI_CODE_HEADER) - 1);
+        ob->length += sizeof(MULTI_CODE_HEADER) - 1;
+        ob->header_written = TRUE;
+    }
+    ob->length += encode_multi_code_format(graph, out, reserve_output(ob, MAXCODELENGTH));
+}
+
+GRAPH_WRITER graph_writer_for_format(const char *format){
+    if(strcmp(format, "wcf")==0 || strcmp(format, "watercluster")==0){
+        return write_watercluster_format;
+    } else if(strcmp(format, "d6")==0 || strcmp(format, "digraph6")==0){
+        return write_digraph6_format;
+    } else if(strcmp(format, "bits")==0 || strcmp(format, "bitset")==0){
+        return write_bitset_format;
+    } else if(strcmp(format, "adj")==0 || strcmp(format, "adjlist")==0){
+        return write_adjlist_format;
+    } else if(strcmp(format, "multi")==0 || strcmp(format, "multi_code")==0){
+        return write_multi_code_format;
+    } else {
+        return NULL;
+    }
+}
+
+GRAPH_WRITER input_writer_for_format(const char *format){
+    if(strcmp(format, "input")==0){
+        return write_input_graph;
+    } else {
+        return graph_writer_for_format(format);
+    }
+}
+
+//large enough for a graph in each of the formats
+static unsigned char encoded_graph[MAXADJLISTLENGTH > MAXCODELENGTH ? MAXADJLISTLENGTH : MAXCODELENGTH];
+
+const unsigned char *encode_graph(GRAPH_WRITER writer, GRAPH graph, DEGREES out, size_t *length){
+    if(writer == write_input_graph){
+        if(input.file == NULL || input.record_length == 0){
+            //nothing was read yet
+            *length = encode_watercluster_format(graph, out, encoded_graph);
+            return encoded_graph;
+        }
+        *length = input.record_length;
+        return input.data + input.record_start;
+    } else if(writer == write_watercluster_format){
+        *length = encode_watercluster_format(graph, out, encoded_graph);
+    } else if(writer == write_digraph6_format){
+        *length = encode_digraph6_format(graph, out, encoded_graph);
+    } else if(writer == write_bitset_format){
+        *length = encode_bitset_format(graph, out, bitset_in_masks, encoded_graph);
+    } else if(writer == write_adjlist_format){
+        *length = encode_adjlist_format(graph, out, encoded_graph);
+    } else if(writer == write_multi_code_format){
+        *length = encode_multi_code_format(graph, out, encoded_graph);
+    } else {
+        fprintf(stderr, "Unknown graph writer -- exiting!\n");
+        exit(1);
+    }
+    return encoded_graph;
+}
+
+size_t encode_graph_header(GRAPH_WRITER writer, unsigned char header[]){
+    if(writer == write_input_graph && input.has_bitset_header){
+        memcpy(header, input.bitset_header, BITSET_HEADER_SIZE);
+        return BITSET_HEADER_SIZE;
+    } else if(writer == write_input_graph && input.has_digraph6_header){
+        memcpy(header, DIGRAPH6_HEADER, sizeof(DIGRAPH6_HEADER) - 1);
+        return sizeof(DIGRAPH6_HEADER) - 1;
+    } else if(writer == write_bitset_format){
+        encode_bitset_header(header, bitset_in_masks);
+        return BITSET_HEADER_SIZE;
+    } else if(writer == write_multi_code_format){
+        memcpy(header, MULTI_CODE_HEADER, sizeof(MULTI_CODE_HEADER) - 1);
+        return sizeof(MULTI_CODE_HEADER) - 1;
+    } else {
+        return 0;
+    }
+}
+
+GRAPH_READER graph_reader_for_format(const char *format){
+    if(strcmp(format, "wcf")==0 || strcmp(format, "watercluster")==0){
+        return read_graph_from_watercluster_file;
+    } else if(strcmp(format, "d6")==0 || strcmp(format, "digraph6")==0){
+        return read_graph_from_digraph6_file;
+    } else if(strcmp(format, "bits")==0 || strcmp(format, "bitset")==0){
+        return read_graph_from_bitset_file;
+    } else if(strcmp(format, "adj")==0 || strcmp(format, "adjlist")==0){
+        return read_graph_from_adjlist_file;
+    } else if(strcmp(format, "multi")==0 || strcmp(format, "multi_code")==0){
+        return read_graph_from_multi_code_file;
+    } else if(strcmp(format, "planar")==0 || strcmp(format, "planar_code")==0){
+        return read_graph_from_planar_code_file;
+    } else {
+        return NULL;
+    }
 }
 
 void print_graph(FILE *f, GRAPH graph, DEGREES out, DEGREES in){
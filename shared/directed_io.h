@@ -12,19 +12,233 @@
 #include <limits.h>
 #include "directed_base.h"
 
-#define MAXCODELENGTH (MAXN * MAXVAL + MAXN)
-#define EMPTY UCHAR_MAX
+#define MAXCODELENGTH (MAXN * MAXVAL + MAXN + 1)
+#define MAXD6LENGTH (3 + (MAXN * MAXN + 5) / 6)
+
+#define DIGRAPH6_HEADER ">>digraph6<<"
+
+typedef void (*GRAPH_WRITER)(GRAPH graph, DEGREES out, FILE *f);
+typedef boolean (*GRAPH_READER)(FILE *f, GRAPH graph, DEGREES out, DEGREES in);
+
+/* A bitset container starts with a header of BITSET_HEADER_SIZE bytes: the 8
+ * bytes of BITSET_MAGIC followed by 32-bit words for the version, a byte order
+ * mark, the flags, the number of rows per mask array, the record size and a
+ * reserved word. The records all have the same size and are described in
+ * directed_io.c. The words are stored in native byte order, since these files
+ * are meant as fast intermediate files and not for exchange.
+ */
+#define BITSET_MAGIC "DGBITS\r\n"
+#define BITSET_VERSION 1
+#define BITSET_BYTE_ORDER 0x01020304U
+#define BITSET_IN_MASKS 1
+#define BITSET_ROWS 32
+#define BITSET_HEADER_SIZE 32
+#define BITSET_RECORD_SIZE(in_masks) (4 * (1 + ((in_masks) ? 2 : 1) * BITSET_ROWS))
+
+//the size of the blocks in which output is buffered and compressed
+#define OUTPUT_BLOCK_SIZE (1 << 18)
+
+//the longest header of a format
+#define MAXHEADERLENGTH BITSET_HEADER_SIZE
+
+/* An index of a file with graphs starts with a header of GRAPH_INDEX_HEADER_SIZE
+ * bytes: the 8 bytes of GRAPH_INDEX_MAGIC, a 32-bit version, a 32-bit format
+ * (0 for watercluster, 1 for digraph6), and the size of the indexed file and
+ * the number of graphs as 64-bit integers. It is followed by the offset of
+ * each graph in the file as a 64-bit integer. All integers are in native byte
+ * order.
+ */
+#define GRAPH_INDEX_MAGIC "DGINDEX\n"
+#define GRAPH_INDEX_VERSION 2
+#define GRAPH_INDEX_HEADER_SIZE 32
+#define GRAPH_INDEX_WATERCLUSTER 0
+#define GRAPH_INDEX_DIGRAPH6 1
+#define GRAPH_INDEX_BITSET 2
+#define GRAPH_INDEX_ADJLIST 3
+#define GRAPH_INDEX_MULTI_CODE 4
+#define GRAPH_INDEX_PLANAR_CODE 5
+
+//values for getopt_long that do not clash with any short option
+#define SELECT_RANGE_OPTION 256
+#define SELECT_IDS_OPTION 257
+#define SELECT_INDEX_OPTION 258
+#define COMPRESS_OPTION 259
+#define COMPRESS_THREADS_OPTION 260
+
+#define SHARED_IO_OPTIONS \
+        {"range", required_argument, NULL, SELECT_RANGE_OPTION}, \
+        {"ids", required_argument, NULL, SELECT_IDS_OPTION}, \
+        {"index", required_argument, NULL, SELECT_INDEX_OPTION}, \
+        {"compress", required_argument, NULL, COMPRESS_OPTION}, \
+        {"compress-threads", required_argument, NULL, COMPRESS_THREADS_OPTION}
 
 #ifdef	__cplusplus
 extern "C" {
 #endif
 
+/**
+ * Only the graphs with numbers in the range first:last are read.
+ */
+void select_graph_range(const char *range);
+
+/**
+ * Only the graphs with numbers listed in the file are read.
+ */
+void select_graph_ids(const char *filename);
+
+/**
+ * Uses the index in the file to jump to the selected graphs.
+ */
+void use_graph_index(const char *filename);
+
+/**
+ * Handles one of the options in SHARED_IO_OPTIONS.
+ */
+void handle_shared_io_option(int option, const char *argument);
+
+void help_shared_io_options(FILE *f);
+
+/**
+ * Returns the number of the last graph that was read (starting from 1).
+ */
+unsigned long long int input_graph_number();
+
+/**
+ * Returns the offset in the input file of the last graph that was read.
+ */
+unsigned long long int input_record_offset();
+
+/**
+ * Returns the offset in the input file after the last byte that was read. Once
+ * all graphs are read, this is the size of the input.
+ */
+unsigned long long int input_end_offset();
+
 boolean read_graph_from_watercluster_file(FILE *f, GRAPH graph, DEGREES out, DEGREES in);
 
+int encode_watercluster_format(GRAPH graph, DEGREES out, unsigned char code[]);
+
+/**
+ * Writes the graph in watercluster format to the output buffer of the file.
+ * Output buffers are flushed with flush_graph_output(), close_graph_output()
+ * or at exit. Do not write other data to the same file through stdio without
+ * flushing the output buffer first.
+ */
 void write_watercluster_format(GRAPH graph, DEGREES out, FILE *f);
 
+/**
+ * Writes an already encoded graph to the output buffer of the file. Codes of
+ * at most OUTPUT_BLOCK_SIZE bytes are never split between two blocks, so they
+ * do not straddle two members of compressed output.
+ */
+void write_graph_code(unsigned char *code, size_t length, FILE *f);
+
+/**
+ * Writes the raw bytes of the last graph that was read from the input,
+ * without encoding it again. The output is therefore byte-identical to the
+ * input and uses the same format. The graph itself is only used if no graph
+ * was read yet, in which case it is written in watercluster format.
+ * 
+ * The record must be written before the next graph is read.
+ */
+void write_input_graph(GRAPH graph, DEGREES out, FILE *f);
+
+void flush_graph_output(FILE *f);
+
+/**
+ * Flushes the output buffer of the file and closes the file.
+ */
+void close_graph_output(FILE *f);
+
 boolean read_graph_from_digraph6_file(FILE *f, GRAPH graph, DEGREES out, DEGREES in);
 
+int encode_digraph6_format(GRAPH graph, DEGREES out, unsigned char code[]);
+
+void write_digraph6_format(GRAPH graph, DEGREES out, FILE *f);
+
+boolean read_graph_from_bitset_file(FILE *f, GRAPH graph, DEGREES out, DEGREES in);
+
+int encode_bitset_format(GRAPH graph, DEGREES out, boolean in_masks, unsigned char record[]);
+
+void decode_bitset_format(const unsigned char *record, boolean in_masks, GRAPH graph, DEGREES out, DEGREES in);
+
+/**
+ * Writes the graph as a record of a bitset container. The header of the
+ * container is written before the first graph in each file.
+ */
+void write_bitset_format(GRAPH graph, DEGREES out, FILE *f);
+
+/**
+ * Sets whether bitset containers that are written contain in-masks.
+ */
+void set_bitset_in_masks(boolean in_masks);
+
+boolean read_graph_from_adjlist_file(FILE *f, GRAPH graph, DEGREES out, DEGREES in);
+
+/**
+ * Writes the graph as adjacency lists in text, one line per vertex followed by
+ * an empty line.
+ */
+void write_adjlist_format(GRAPH graph, DEGREES out, FILE *f);
+
+/**
+ * Sets whether vertices in adjacency lists are numbered starting from 0
+ * instead of 1.
+ */
+void set_adjlist_zero_based(boolean zero_based);
+
+/**
+ * Reads an undirected graph in multi_code as a symmetric digraph.
+ */
+boolean read_graph_from_multi_code_file(FILE *f, GRAPH graph, DEGREES out, DEGREES in);
+
+/**
+ * Reads an undirected plane graph in planar_code as a symmetric digraph. The
+ * embedding is not used.
+ */
+boolean read_graph_from_planar_code_file(FILE *f, GRAPH graph, DEGREES out, DEGREES in);
+
+int encode_multi_code_format(GRAPH graph, DEGREES out, unsigned char code[]);
+
+/**
+ * Writes the underlying undirected graph in multi_code. The header is written
+ * before the first graph in each file.
+ */
+void write_multi_code_format(GRAPH graph, DEGREES out, FILE *f);
+
+/**
+ * Returns the function that writes graphs in the given format (wcf, d6, bits,
+ * adj or multi), or NULL if the format is unknown.
+ */
+GRAPH_WRITER graph_writer_for_format(const char *format);
+
+/**
+ * As graph_writer_for_format, but also accepts input for write_input_graph.
+ * Only for tools that write the graphs they have read without changing them.
+ */
+GRAPH_WRITER input_writer_for_format(const char *format);
+
+/**
+ * Encodes the graph in the format of the writer without writing it, e.g. to
+ * collect graphs in memory. For write_input_graph this is the raw input record.
+ * The returned bytes are only valid until the next graph is encoded or read.
+ * The header of the format is not included.
+ */
+const unsigned char *encode_graph(GRAPH_WRITER writer, GRAPH graph, DEGREES out, size_t *length);
+
+/**
+ * Stores the header that the writer writes before the first graph in each file
+ * (at most MAXHEADERLENGTH bytes), and returns its length or 0 if the format
+ * has no header.
+ */
+size_t encode_graph_header(GRAPH_WRITER writer, unsigned char header[]);
+
+/**
+ * Returns the function that reads graphs in the given format (wcf, d6, bits,
+ * adj, multi or planar), or NULL if the format is unknown.
+ */
+GRAPH_READER graph_reader_for_format(const char *format);
+
 /**
  * Prints a human readable representation of the graph.
  */
@@ -0,0 +1,371 @@
+/*
+ * File:   directed_pattern.c
+ * Author: nvcleemp
+ *
+ * Created on October 18, 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "directed_pattern.h"
+
+struct _pattern {
+    char *name;
+    int order;
+    BITSET out[MAXPATTERN + 1];
+    BITSET in[MAXPATTERN + 1];
+
+    //the matching order
+    int vertex[MAXPATTERN]; //the vertex of the pattern that is matched in each step
+    unsigned int arcs_from[MAXPATTERN]; //the earlier steps with an arc to this step
+    unsigned int arcs_to[MAXPATTERN]; //the earlier steps with an arc from this step
+
+    int automorphism_count;
+    unsigned char (*automorphisms)[MAXPATTERN + 1];
+};
+
+typedef struct {
+    PATTERN *pattern;
+    int flags;
+    BITSET out_masks[MAXN + 1];
+    BITSET in_masks[MAXN + 1];
+    BITSET candidates[MAXPATTERN]; //the vertices with large enough degrees for each step
+    BITSET non_quartic;
+    int image[MAXPATTERN + 1];
+    int step_image[MAXPATTERN];
+    boolean first_only;
+    boolean stop;
+    PATTERN_CALLBACK found;
+    void *data;
+    unsigned long long int count;
+} MATCH;
+
+static const char *named_patterns[][2] = {
+    {"2cycle", "1>2 2>1"},
+    {"3cycle", "1>2>3>1"},
+    {"z6", "1>2>3>1 1>4>3 2>5>1 3>6>2"}
+};
+
+#define NAMED_PATTERN_COUNT (sizeof(named_patterns)/sizeof(named_patterns[0]))
+
+//================ MATCHING ===================
+
+/**
+ * Returns TRUE if no automorphism of the pattern gives an embedding of the
+ * same copy with lexicographically smaller images.
+ */
+static boolean is_canonical(PATTERN *p, const int image[]){
+    int a, v;
+    for(a = 0; a < p->automorphism_count; a++){
+        for(v = 1; v <= p->order; v++){
+            int w = image[p->automorphisms[a][v]];
+            if(w != image[v]){
+                if(w < image[v]){
+                    return FALSE;
+                }
+                break;
+            }
+        }
+    }
+    return TRUE;
+}
+
+static void embedding_found(MATCH *m, BITSET used){
+    if((m->flags & PATTERN_NON_QUARTIC) && !(used & m->non_quartic)){
+        return;
+    }
+    if(m->found != NULL){
+        if(!is_canonical(m->pattern, m->image)){
+            return;
+        }
+        m->found(m->pattern, m->image, m->data);
+    }
+    m->count++;
+    if(m->first_only){
+        m->stop = TRUE;
+    }
+}
+
+static void match_step(MATCH *m, int step, BITSET used){
+    PATTERN *p = m->pattern;
+    int j;
+
+    if(step == p->order){
+        embedding_found(m, used);
+        return;
+    }
+
+    BITSET candidates = m->candidates[step] & ~used;
+    for(j = 0; j < step && candidates; j++){
+        int w = m->step_image[j];
+        if(p->arcs_from[step] & (1U << j)){
+            candidates &= m->out_masks[w];
+        } else if(m->flags & PATTERN_INDUCED){
+            candidates &= ~m->out_masks[w];
+        }
+        if(p->arcs_to[step] & (1U << j)){
+            candidates &= m->in_masks[w];
+        } else if(m->flags & PATTERN_INDUCED){
+            candidates &= ~m->in_masks[w];
+        }
+    }
+
+    while(candidates && !m->stop){
+        int w = __builtin_ctzll(candidates);
+        candidates &= candidates - 1;
+        m->step_image[step] = w;
+        m->image[p->vertex[step]] = w;
+        match_step(m, step + 1, used | BIT(w));
+    }
+}
+
+static unsigned long long int match_pattern(PATTERN *p, GRAPH graph, DEGREES out, DEGREES in, int flags,
+        boolean first_only, PATTERN_CALLBACK found, void *data){
+    MATCH m;
+    int v, step;
+
+    if(p->order > graph[0][0]){
+        return 0;
+    }
+
+    m.pattern = p;
+    m.flags = flags;
+    m.first_only = first_only;
+    m.stop = FALSE;
+    m.found = found;
+    m.data = data;
+    m.count = 0;
+
+    neighbourhood_masks(graph, out, m.out_masks, m.in_masks);
+    m.non_quartic = 0;
+    for(v = 1; v <= graph[0][0]; v++){
+        if(out[v] != 2 || in[v] != 2){
+            m.non_quartic |= BIT(v);
+        }
+    }
+    for(step = 0; step < p->order; step++){
+        int pout = __builtin_popcountll(p->out[p->vertex[step]]);
+        int pin = __builtin_popcountll(p->in[p->vertex[step]]);
+        m.candidates[step] = 0;
+        for(v = 1; v <= graph[0][0]; v++){
+            if(out[v] >= pout && in[v] >= pin){
+                m.candidates[step] |= BIT(v);
+            }
+        }
+        if(flags & PATTERN_QUARTIC){
+            m.candidates[step] &= ~m.non_quartic;
+        }
+    }
+
+    match_step(&m, 0, 0);
+
+    return m.count;
+}
+
+boolean has_pattern(PATTERN *pattern, GRAPH graph, DEGREES out, DEGREES in, int flags){
+    return match_pattern(pattern, graph, out, in, flags, TRUE, NULL, NULL) > 0;
+}
+
+unsigned long long int count_pattern(PATTERN *pattern, GRAPH graph, DEGREES out, DEGREES in, int flags){
+    //each copy is found once for each automorphism
+    return match_pattern(pattern, graph, out, in, flags, FALSE, NULL, NULL) / pattern->automorphism_count;
+}
+
+unsigned long long int find_pattern(PATTERN *pattern, GRAPH graph, DEGREES out, DEGREES in, int flags,
+        PATTERN_CALLBACK found, void *data){
+    return match_pattern(pattern, graph, out, in, flags, FALSE, found, data);
+}
+
+//================ PATTERNS ===================
+
+static void pattern_error(const char *message, const char *text){
+    fprintf(stderr, "%s in pattern \"%s\" -- exiting!\n", message, text);
+    exit(EXIT_FAILURE);
+}
+
+static int parse_vertex(const char **s, const char *text){
+    int v = 0;
+    if(!isdigit((unsigned char) **s)){
+        pattern_error("Expected a vertex", text);
+    }
+    while(isdigit((unsigned char) **s)){
+        v = 10*v + (**s - '0');
+        if(v > MAXPATTERN){
+            pattern_error("Too many vertices", text);
+        }
+        (*s)++;
+    }
+    if(v == 0){
+        pattern_error("Vertices are numbered from 1", text);
+    }
+    return v;
+}
+
+/**
+ * The vertex with the most arcs to the vertices that are already matched is
+ * matched next. Ties are broken by the degree.
+ */
+static void compute_matching_order(PATTERN *p){
+    BITSET matched = 0;
+    int step, v, j;
+    for(step = 0; step < p->order; step++){
+        int best = 0, best_arcs = -1, best_degree = -1;
+        for(v = 1; v <= p->order; v++){
+            if(matched & BIT(v)) continue;
+            int arcs = __builtin_popcountll(p->out[v] & matched) + __builtin_popcountll(p->in[v] & matched);
+            int degree = __builtin_popcountll(p->out[v]) + __builtin_popcountll(p->in[v]);
+            if(arcs > best_arcs || (arcs == best_arcs && degree > best_degree)){
+                best = v;
+                best_arcs = arcs;
+                best_degree = degree;
+            }
+        }
+        p->vertex[step] = best;
+        p->arcs_from[step] = p->arcs_to[step] = 0;
+        for(j = 0; j < step; j++){
+            if(p->out[p->vertex[j]] & BIT(best)){
+                p->arcs_from[step] |= 1U << j;
+            }
+            if(p->in[p->vertex[j]] & BIT(best)){
+                p->arcs_to[step] |= 1U << j;
+            }
+        }
+        matched |= BIT(best);
+    }
+}
+
+typedef struct {
+    int count;
+    int capacity;
+    unsigned char (*automorphisms)[MAXPATTERN + 1];
+} AUTOMORPHISMS;
+
+static void store_automorphism(PATTERN *p, const int image[], void *data){
+    AUTOMORPHISMS *a = (AUTOMORPHISMS *) data;
+    int v;
+    if(a->count == a->capacity){
+        a->capacity = a->capacity ? 2 * a->capacity : 8;
+        a->automorphisms = realloc(a->automorphisms, a->capacity * sizeof(a->automorphisms[0]));
+        if(a->automorphisms == NULL){
+            fprintf(stderr, "Could not store the automorphisms of a pattern -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for(v = 1; v <= p->order; v++){
+        a->automorphisms[a->count][v] = image[v];
+    }
+    a->count++;
+}
+
+/**
+ * The automorphisms are the induced embeddings of the pattern in itself.
+ */
+static void compute_automorphisms(PATTERN *p){
+    GRAPH graph;
+    DEGREES out, in;
+    AUTOMORPHISMS a = {0, 0, NULL};
+    int v, w;
+
+    graph[0][0] = p->order;
+    for(v = 1; v <= p->order; v++){
+        out[v] = 0;
+        in[v] = __builtin_popcountll(p->in[v]);
+        for(w = 1; w <= p->order; w++){
+            if(p->out[v] & BIT(w)){
+                graph[v][out[v]++] = w;
+            }
+        }
+    }
+
+    //without automorphisms each embedding is canonical, so all are collected
+    p->automorphism_count = 0;
+    p->automorphisms = NULL;
+    match_pattern(p, graph, out, in, PATTERN_INDUCED, FALSE, store_automorphism, &a);
+    p->automorphism_count = a.count;
+    p->automorphisms = a.automorphisms;
+}
+
+PATTERN *parse_pattern(const char *text){
+    PATTERN *p;
+    const char *s = text;
+    unsigned int i;
+
+    for(i = 0; i < NAMED_PATTERN_COUNT; i++){
+        if(!strcmp(text, named_patterns[i][0])){
+            s = named_patterns[i][1];
+        }
+    }
+
+    p = malloc(sizeof(PATTERN));
+    if(p == NULL){
+        fprintf(stderr, "Could not allocate pattern -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    p->name = strdup(text);
+    p->order = 0;
+    memset(p->out, 0, sizeof(p->out));
+    memset(p->in, 0, sizeof(p->in));
+
+    while(isspace((unsigned char) *s)) s++;
+    if(isdigit((unsigned char) *s) && strchr(s, ':') != NULL){
+        const char *colon = s;
+        while(isdigit((unsigned char) *colon)) colon++;
+        if(*colon == ':'){
+            p->order = parse_vertex(&s, text);
+            s++;
+        }
+    }
+
+    //arcs are separated by spaces or commas, and a>b>c is short for a>b b>c
+    while(*s){
+        if(isspace((unsigned char) *s) || *s == ','){
+            s++;
+            continue;
+        }
+        int from = parse_vertex(&s, text);
+        if(*s != '>'){
+            pattern_error("Expected an arc", text);
+        }
+        while(*s == '>'){
+            s++;
+            int to = parse_vertex(&s, text);
+            if(from == to){
+                pattern_error("Loops are not allowed", text);
+            }
+            p->out[from] |= BIT(to);
+            p->in[to] |= BIT(from);
+            if(from > p->order) p->order = from;
+            if(to > p->order) p->order = to;
+            from = to;
+        }
+    }
+    if(p->order == 0){
+        pattern_error("No vertices", text);
+    }
+
+    compute_matching_order(p);
+    compute_automorphisms(p);
+
+    return p;
+}
+
+void free_pattern(PATTERN *pattern){
+    free(pattern->automorphisms);
+    free(pattern->name);
+    free(pattern);
+}
+
+const char *pattern_name(PATTERN *pattern){
+    return pattern->name;
+}
+
+int pattern_order(PATTERN *pattern){
+    return pattern->order;
+}
+
+int pattern_automorphism_count(PATTERN *pattern){
+    return pattern->automorphism_count;
+}
+
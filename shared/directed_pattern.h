@@ -0,0 +1,91 @@
+/*
+ * File:   directed_pattern.h
+ * Author: nvcleemp
+ *
+ * Created on October 18, 2026
+ */
+
+#ifndef DIRECTED_PATTERN_H
+#define	DIRECTED_PATTERN_H
+
+#include "directed_base.h"
+
+/* A matcher for small pattern digraphs. A pattern is given as a list of arcs,
+ * e.g.
+ *
+ *     1>2 2>3 3>1
+ *
+ * for a directed 3-cycle. The vertices are numbered from 1, and a prefix n:
+ * sets the order if there are isolated vertices. The names 2cycle, 3cycle and
+ * z6 can be used for these patterns.
+ *
+ * The vertices of the pattern are matched in a fixed order that is computed
+ * once: each next vertex has as many arcs as possible to the vertices that
+ * are already matched. The candidates for a vertex are then found as the
+ * intersection of the bitsets of the out- and in-neighbourhoods of the images
+ * of these vertices.
+ *
+ * A copy of the pattern is a subgraph that is isomorphic to the pattern.
+ * Each copy corresponds to as many embeddings as the pattern has
+ * automorphisms, and only one of these is reported.
+ */
+
+#define MAXPATTERN 8
+
+/* The arcs between vertices of a copy are exactly the arcs of the pattern. */
+#define PATTERN_INDUCED 1
+/* All vertices of a copy have in-degree and out-degree 2. */
+#define PATTERN_QUARTIC 2
+/* Some vertex of a copy has a larger in-degree or out-degree. */
+#define PATTERN_NON_QUARTIC 4
+
+typedef struct _pattern PATTERN;
+
+/**
+ * Is called for each copy of the pattern. The image of vertex v of the pattern
+ * is image[v].
+ */
+typedef void (*PATTERN_CALLBACK)(PATTERN *pattern, const int image[], void *data);
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/**
+ * Parses the pattern, and exits with an error message if it is not valid.
+ */
+PATTERN *parse_pattern(const char *text);
+
+void free_pattern(PATTERN *pattern);
+
+/**
+ * Returns the text from which the pattern was parsed.
+ */
+const char *pattern_name(PATTERN *pattern);
+
+int pattern_order(PATTERN *pattern);
+
+int pattern_automorphism_count(PATTERN *pattern);
+
+/**
+ * The flags are a combination of PATTERN_INDUCED and either PATTERN_QUARTIC or
+ * PATTERN_NON_QUARTIC.
+ */
+boolean has_pattern(PATTERN *pattern, GRAPH graph, DEGREES out, DEGREES in, int flags);
+
+unsigned long long int count_pattern(PATTERN *pattern, GRAPH graph, DEGREES out, DEGREES in, int flags);
+
+/**
+ * Calls found for each copy of the pattern, and returns the number of copies.
+ * Of the embeddings of a copy, the one with the lexicographically smallest
+ * images is reported.
+ */
+unsigned long long int find_pattern(PATTERN *pattern, GRAPH graph, DEGREES out, DEGREES in, int flags,
+        PATTERN_CALLBACK found, void *data);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* DIRECTED_PATTERN_H */
+
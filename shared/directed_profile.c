@@ -0,0 +1,186 @@
+/*
+ * File:   directed_profile.c
+ * Author: nvcleemp
+ *
+ * Created on October 18, 2026
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "directed_profile.h"
+
+#ifdef PROFILE_PHASES
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TIMESTAMP() __rdtsc()
+#else
+static unsigned long long int nanoseconds(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+#define TIMESTAMP() nanoseconds()
+#endif
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#define COUNTER_COUNT 5
+
+static const char *counter_names[COUNTER_COUNT] = {
+    "cycles", "instructions", "branch-misses", "L1D-misses", "LLC-misses"
+};
+
+static boolean initialised = FALSE;
+static boolean have_counters = FALSE;
+static int group_fd = -1;
+
+static unsigned long long int phase_calls[PHASE_COUNT];
+static unsigned long long int phase_ticks[PHASE_COUNT];
+static unsigned long long int phase_counters[PHASE_COUNT][COUNTER_COUNT];
+
+static unsigned long long int start_ticks[PHASE_COUNT];
+static unsigned long long int start_counters[PHASE_COUNT][COUNTER_COUNT];
+
+#ifdef __linux__
+static int open_counter(unsigned int type, unsigned long long int config, int group){
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    return (int) syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+static void open_counters(){
+    int i;
+    int fds[COUNTER_COUNT];
+    unsigned int types[COUNTER_COUNT] = {
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+        PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE
+    };
+    unsigned long long int configs[COUNTER_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_MISSES
+    };
+
+    for(i = 0; i < COUNTER_COUNT; i++){
+        fds[i] = open_counter(types[i], configs[i], i ? fds[0] : -1);
+        if(fds[i] == -1){
+            //counters are not available (not supported or not permitted)
+            while(i > 0){
+                close(fds[--i]);
+            }
+            return;
+        }
+    }
+    group_fd = fds[0];
+    ioctl(group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    have_counters = TRUE;
+}
+
+static void read_counters(unsigned long long int values[COUNTER_COUNT]){
+    unsigned long long int buffer[COUNTER_COUNT + 1];
+    int i;
+
+    if(read(group_fd, buffer, sizeof(buffer)) != sizeof(buffer)){
+        for(i = 0; i < COUNTER_COUNT; i++){
+            values[i] = 0;
+        }
+        return;
+    }
+    //the first value is the number of counters in the group
+    for(i = 0; i < COUNTER_COUNT; i++){
+        values[i] = buffer[i + 1];
+    }
+}
+#else
+static void open_counters(){
+}
+
+static void read_counters(unsigned long long int values[COUNTER_COUNT]){
+}
+#endif
+
+static void profile_report(){
+    int i, j;
+
+    fprintf(stderr, "\n%-10s %12s %16s", "phase", "calls", "ticks");
+    if(have_counters){
+        for(j = 0; j < COUNTER_COUNT; j++){
+            fprintf(stderr, " %16s", counter_names[j]);
+        }
+    }
+    fprintf(stderr, "\n");
+    for(i = 0; i < PHASE_COUNT; i++){
+        fprintf(stderr, "%-10s %12llu %16llu", phase_name(i), phase_calls[i], phase_ticks[i]);
+        if(have_counters){
+            for(j = 0; j < COUNTER_COUNT; j++){
+                fprintf(stderr, " %16llu", phase_counters[i][j]);
+            }
+        }
+        fprintf(stderr, "\n");
+    }
+    if(!have_counters){
+        fprintf(stderr, "Hardware counters were not available.\n");
+    }
+}
+
+static void profile_init(){
+    initialised = TRUE;
+    open_counters();
+    atexit(profile_report);
+}
+
+void profile_start(PHASE phase){
+    if(!initialised){
+        profile_init();
+    }
+    if(have_counters){
+        read_counters(start_counters[phase]);
+    }
+    start_ticks[phase] = TIMESTAMP();
+}
+
+void profile_stop(PHASE phase){
+    int j;
+    unsigned long long int ticks = TIMESTAMP();
+
+    phase_calls[phase]++;
+    phase_ticks[phase] += ticks - start_ticks[phase];
+    if(have_counters){
+        unsigned long long int values[COUNTER_COUNT];
+        read_counters(values);
+        for(j = 0; j < COUNTER_COUNT; j++){
+            phase_counters[phase][j] += values[j] - start_counters[phase][j];
+        }
+    }
+}
+
+#else
+
+void profile_start(PHASE phase){
+}
+
+void profile_stop(PHASE phase){
+}
+
+#endif
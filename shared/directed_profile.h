@@ -0,0 +1,35 @@
+/*
+ * File:   directed_profile.h
+ * Author: nvcleemp
+ *
+ * Created on October 18, 2026
+ */
+
+#ifndef DIRECTED_PROFILE_H
+#define	DIRECTED_PROFILE_H
+
+#include "directed_stats.h"
+
+/* Profiling is only compiled in when PROFILE_PHASES is defined, e.g.
+ *
+ *     make CFLAGS="-O4 -DPROFILE_PHASES"
+ *
+ * Each phase is then timed with the time stamp counter and, on Linux, the
+ * hardware counters for cycles, instructions, branch misses, L1 data cache
+ * misses and last level cache misses are read through perf_event_open. The
+ * totals per phase are printed to standard error when the program exits.
+ */
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+void profile_start(PHASE phase);
+void profile_stop(PHASE phase);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* DIRECTED_PROFILE_H */
+
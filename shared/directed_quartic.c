@@ -0,0 +1,170 @@
+/*
+ * File:   directed_quartic.c
+ * Author: nvcleemp
+ *
+ * Created on October 18, 2026
+ */
+
+#include "directed_quartic.h"
+#include "directed_stats.h"
+
+boolean make_quartic_graph(GRAPH graph, DEGREES out, QUARTIC_GRAPH *q){
+    DEGREES in;
+    int v;
+    
+    q->order = graph[0][0];
+    for(v = 1; v <= q->order; v++){
+        if(out[v] != QUARTIC_DEGREE){
+            return FALSE;
+        }
+        in[v] = 0;
+    }
+    for(v = 1; v <= q->order; v++){
+        int w0 = graph[v][0], w1 = graph[v][1];
+        if(in[w0] == QUARTIC_DEGREE || in[w1] == QUARTIC_DEGREE){
+            return FALSE;
+        }
+        q->out[v][0] = w0;
+        q->out[v][1] = w1;
+        q->in[w0][in[w0]++] = v;
+        q->in[w1][in[w1]++] = v;
+    }
+    //all in-degrees are at most 2 and sum to 2n, so they are all 2
+    return TRUE;
+}
+
+//================ CYCLES ===================
+
+/**
+ * Returns the in-neighbour of v that is not u.
+ */
+static inline int other_predecessor(const QUARTIC_GRAPH *q, int v, int u){
+    return q->in[v][0] == u ? q->in[v][1] : q->in[v][0];
+}
+
+/**
+ * The cycle continues with last -> next, so the arc last -> skipped is not
+ * used. Returns FALSE if skipped can then no longer be entered: its other
+ * in-neighbour should still be free or be next. The first vertex of the cycle
+ * still has to be entered at the end.
+ */
+static inline boolean can_skip(const QUARTIC_GRAPH *q, BITSET visited, int last, int next, int skipped, int first){
+    int p;
+    if((visited & BIT(skipped)) && skipped != first){
+        return TRUE;
+    }
+    p = other_predecessor(q, skipped, last);
+    return p == next || !(visited & BIT(p));
+}
+
+/**
+ * The successor of each vertex on the current path is stored in next.
+ */
+static boolean continue_quartic_cycle(const QUARTIC_GRAPH *q, BITSET visited, int last, int remaining, int first,
+        unsigned char next[]){
+    int a = q->out[last][0];
+    int b = q->out[last][1];
+
+    COUNT_SEARCH_NODE();
+
+    if(remaining == 0){
+        next[last] = first;
+        return a == first || b == first;
+    }
+    next[last] = a;
+    if(!(visited & BIT(a)) && can_skip(q, visited | BIT(a), last, a, b, first) &&
+            continue_quartic_cycle(q, visited | BIT(a), a, remaining - 1, first, next)){
+        return TRUE;
+    }
+    next[last] = b;
+    if(!(visited & BIT(b)) && can_skip(q, visited | BIT(b), last, b, a, first) &&
+            continue_quartic_cycle(q, visited | BIT(b), b, remaining - 1, first, next)){
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/**
+ * Searches a hamiltonian cycle through the start vertex in the graph without
+ * the vertices in removed. The order is the number of remaining vertices.
+ */
+static boolean start_quartic_cycle(const QUARTIC_GRAPH *q, BITSET removed, int start, int order){
+    unsigned char next[MAXN + 1];
+    return continue_quartic_cycle(q, removed | BIT(start), start, order - 1, start, next);
+}
+
+/**
+ * Searches a hamiltonian cycle through the arc v1 -> v2 in the graph without
+ * the vertices in removed. As in the general search, the cycle has at least
+ * three vertices.
+ */
+static boolean start_quartic_cycle_through_arc(const QUARTIC_GRAPH *q, BITSET removed, int v1, int v2, int order,
+        unsigned char next[]){
+    BITSET visited = removed | BIT(v1) | BIT(v2);
+    int skipped = q->out[v1][0] == v2 ? q->out[v1][1] : q->out[v1][0];
+    next[v1] = v2;
+    return order >= 3 && can_skip(q, visited, v1, v2, skipped, v1) &&
+            continue_quartic_cycle(q, visited, v2, order - 2, v1, next);
+}
+
+boolean quartic_contains_hamiltonian_cycle(const QUARTIC_GRAPH *q){
+    return start_quartic_cycle(q, 0, 1, q->order);
+}
+
+boolean quartic_vertex_deleted_cycle(const QUARTIC_GRAPH *q, int v, unsigned char successor[]){
+    if(v == 0){
+        return continue_quartic_cycle(q, BIT(1), 1, q->order - 1, 1, successor);
+    }
+    int start = v == 1 ? 2 : 1;
+    return continue_quartic_cycle(q, BIT(v) | BIT(start), start, q->order - 2, start, successor);
+}
+
+boolean quartic_vertex_deleted_cycle_through_arc(const QUARTIC_GRAPH *q, int v, int v1, int v2, unsigned char successor[]){
+    return start_quartic_cycle_through_arc(q, BIT(v), v1, v2, q->order - 1, successor);
+}
+
+//================ Z6 ===================
+
+/**
+ * Returns the out-neighbour of v that is not u.
+ */
+static inline int other_successor(const QUARTIC_GRAPH *q, int v, int u){
+    return q->out[v][0] == u ? q->out[v][1] : q->out[v][0];
+}
+
+static inline boolean has_quartic_arc(const QUARTIC_GRAPH *q, int from, int to){
+    return q->out[from][0] == to || q->out[from][1] == to;
+}
+
+unsigned long long int quartic_count_z6(const QUARTIC_GRAPH *q, boolean first_only){
+    int x, i, j;
+    unsigned long long int count = 0;
+
+    //check all 3-cycles x -> y -> z -> x with x the smallest vertex
+    for(x = 1; x <= q->order; x++){
+        for(i = 0; i < QUARTIC_DEGREE; i++){
+            int y = q->out[x][i];
+            if(y < x) continue;
+            for(j = 0; j < QUARTIC_DEGREE; j++){
+                int z = q->out[y][j];
+                if(z < x || !has_quartic_arc(q, z, x)) continue;
+                
+                //the only candidate ear of each arc is the other out-neighbour
+                int ear_x = other_successor(q, x, y); //x -> x' -> z
+                int ear_y = other_successor(q, y, z); //y -> y' -> x
+                int ear_z = other_successor(q, z, x); //z -> z' -> y
+                BITSET ears = BIT(ear_x) | BIT(ear_y) | BIT(ear_z);
+                if(__builtin_popcountll(ears) == 3 && !(ears & (BIT(x) | BIT(y) | BIT(z))) &&
+                        has_quartic_arc(q, ear_x, z) && has_quartic_arc(q, ear_y, x) &&
+                        has_quartic_arc(q, ear_z, y)){
+                    count++;
+                    if(first_only){
+                        return count;
+                    }
+                }
+            }
+        }
+    }
+    return count;
+}
+
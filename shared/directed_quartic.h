@@ -0,0 +1,67 @@
+/*
+ * File:   directed_quartic.h
+ * Author: nvcleemp
+ *
+ * Created on October 18, 2026
+ */
+
+#ifndef DIRECTED_QUARTIC_H
+#define	DIRECTED_QUARTIC_H
+
+#include "directed_base.h"
+
+/* Kernels for 2-in 2-out (quartic) digraphs. Each vertex has exactly two
+ * out-neighbours and two in-neighbours, which are stored in fixed slots, so
+ * the searches have no loops over neighbours. In the search for a hamiltonian
+ * cycle each arc that is not used rules out one of the two ways to enter its
+ * head, so dead ends are found as soon as the other way is closed as well.
+ * 
+ * The functions in directed_hamiltonian.h and directed_z6.h use these kernels
+ * automatically when the graph is quartic.
+ */
+
+#define QUARTIC_DEGREE 2
+
+typedef struct {
+    int order;
+    unsigned char out[MAXN + 1][QUARTIC_DEGREE];
+    unsigned char in[MAXN + 1][QUARTIC_DEGREE];
+} QUARTIC_GRAPH;
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/**
+ * Stores the graph in the quartic layout, and returns FALSE if the graph is
+ * not quartic.
+ */
+boolean make_quartic_graph(GRAPH graph, DEGREES out, QUARTIC_GRAPH *q);
+
+boolean quartic_contains_hamiltonian_cycle(const QUARTIC_GRAPH *q);
+
+/**
+ * Searches a hamiltonian cycle in the graph without v, or in the graph itself
+ * if v is 0. If there is one, successor[u] is the vertex after u on this
+ * cycle.
+ */
+boolean quartic_vertex_deleted_cycle(const QUARTIC_GRAPH *q, int v, unsigned char successor[]);
+
+/**
+ * Searches a hamiltonian cycle through the arc v1 -> v2 in the graph without
+ * v. If there is one, successor[u] is the vertex after u on this cycle.
+ */
+boolean quartic_vertex_deleted_cycle_through_arc(const QUARTIC_GRAPH *q, int v, int v1, int v2, unsigned char successor[]);
+
+/**
+ * Returns the number of copies of Z6, or stops at the first copy if
+ * first_only is TRUE.
+ */
+unsigned long long int quartic_count_z6(const QUARTIC_GRAPH *q, boolean first_only);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* DIRECTED_QUARTIC_H */
+
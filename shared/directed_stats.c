@@ -0,0 +1,347 @@
+/*
+ * File:   directed_stats.c
+ * Author: nvcleemp
+ *
+ * Created on October 18, 2026
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "directed_stats.h"
+#include "directed_io.h"
+#include "directed_profile.h"
+
+#ifdef COUNT_SEARCH_NODES
+__thread unsigned long long int search_nodes = 0;
+static unsigned long long int merged_search_nodes = 0;
+#endif
+
+static boolean enabled = FALSE;
+static char *stats_filename = NULL;
+
+//TRUE if the time per graph needs to be measured
+static boolean time_graphs = FALSE;
+
+static unsigned long long int stats_graphs_read = 0;
+static unsigned long long int stats_graphs_accepted = 0;
+static unsigned long long int stats_graphs_written = 0;
+
+static const char *stage_names[MAX_STAGES];
+static unsigned long long int stage_rejections[MAX_STAGES];
+static int stage_count = 0;
+
+static unsigned long long int nodes_at_last_graph = 0;
+static unsigned long long int max_nodes = 0;
+static unsigned long long int max_nodes_graph = 0;
+
+static double graph_start;
+static double last_time = 0.0;
+static unsigned long long int last_nodes = 0;
+
+typedef struct _hard_graph {
+    double cost;
+    unsigned long long int number;
+    unsigned long long int nodes;
+    double time;
+    int length;
+    unsigned char code[MAXCODELENGTH];
+} HARD_GRAPH;
+
+//min-heap on the cost, so the easiest of the hardest graphs is at the root
+static HARD_GRAPH *hardest = NULL;
+static int hardest_size = 0;
+static int hardest_count = 0;
+static char *hardest_filename = NULL;
+
+static const char *phase_names[PHASE_COUNT] = {"decode", "prefilter", "search", "encode"};
+static double phase_wall[PHASE_COUNT];
+static double phase_cpu[PHASE_COUNT];
+static double phase_wall_start[PHASE_COUNT];
+static double phase_cpu_start[PHASE_COUNT];
+
+static double run_wall_start;
+static double run_cpu_start;
+
+static double seconds(clockid_t clock){
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void enable_statistics(char *filename){
+    int i;
+
+    enabled = TRUE;
+    time_graphs = TRUE;
+    stats_filename = filename;
+    for(i = 0; i < PHASE_COUNT; i++){
+        phase_wall[i] = phase_cpu[i] = 0.0;
+    }
+    run_wall_start = seconds(CLOCK_MONOTONIC);
+    run_cpu_start = seconds(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+boolean statistics_enabled(){
+    return enabled;
+}
+
+void register_rejection_stage(int stage, const char *name){
+    if(stage < 0 || stage >= MAX_STAGES){
+        fprintf(stderr, "Illegal rejection stage %d -- exiting!\n", stage);
+        exit(EXIT_FAILURE);
+    }
+    stage_names[stage] = name;
+    stage_rejections[stage] = 0;
+    if(stage >= stage_count){
+        stage_count = stage + 1;
+    }
+}
+
+const char *phase_name(PHASE phase){
+    return phase_names[phase];
+}
+
+void start_phase(PHASE phase){
+#ifdef PROFILE_PHASES
+    profile_start(phase);
+#endif
+    if(!enabled) return;
+    phase_wall_start[phase] = seconds(CLOCK_MONOTONIC);
+    phase_cpu_start[phase] = seconds(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+void stop_phase(PHASE phase){
+#ifdef PROFILE_PHASES
+    profile_stop(phase);
+#endif
+    if(!enabled) return;
+    phase_wall[phase] += seconds(CLOCK_MONOTONIC) - phase_wall_start[phase];
+    phase_cpu[phase] += seconds(CLOCK_PROCESS_CPUTIME_ID) - phase_cpu_start[phase];
+}
+
+void reject_at_stage(int stage){
+    stage_rejections[stage]++;
+}
+
+unsigned long long int current_search_nodes(){
+#ifdef COUNT_SEARCH_NODES
+    return search_nodes - nodes_at_last_graph;
+#else
+    return 0ULL;
+#endif
+}
+
+void merge_thread_search_nodes(){
+#ifdef COUNT_SEARCH_NODES
+    __sync_fetch_and_add(&merged_search_nodes, search_nodes);
+    search_nodes = 0;
+#endif
+}
+
+unsigned long long int total_search_nodes(){
+#ifdef COUNT_SEARCH_NODES
+    return search_nodes + __sync_fetch_and_add(&merged_search_nodes, 0);
+#else
+    return 0ULL;
+#endif
+}
+
+void start_graph(){
+    if(time_graphs){
+        graph_start = seconds(CLOCK_MONOTONIC);
+    }
+}
+
+void graph_processed(boolean accepted){
+    unsigned long long int nodes = current_search_nodes();
+    
+    if(time_graphs){
+        last_time = seconds(CLOCK_MONOTONIC) - graph_start;
+    }
+    last_nodes = nodes;
+
+    stats_graphs_read++;
+    if(accepted){
+        stats_graphs_accepted++;
+    }
+    if(nodes > max_nodes){
+        max_nodes = nodes;
+        max_nodes_graph = input_graph_number();
+    }
+    nodes_at_last_graph += nodes;
+}
+
+double last_graph_time(){
+    return last_time;
+}
+
+unsigned long long int last_graph_search_nodes(){
+    return last_nodes;
+}
+
+void enable_hardness(){
+    time_graphs = TRUE;
+}
+
+void print_hardness(FILE *f){
+    fprintf(f, "\t%llu\t%.9f", last_nodes, last_time);
+}
+
+void enable_hardest_graphs(int size, char *filename){
+    if(size <= 0){
+        fprintf(stderr, "The number of hardest graphs should be positive -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    hardest = (HARD_GRAPH *)malloc(size * sizeof(HARD_GRAPH));
+    if(hardest == NULL){
+        fprintf(stderr, "Insufficient memory\n");
+        exit(EXIT_FAILURE);
+    }
+    hardest_size = size;
+    hardest_count = 0;
+    hardest_filename = filename;
+    time_graphs = TRUE;
+}
+
+static void swap_hard_graphs(int i, int j){
+    HARD_GRAPH temp = hardest[i];
+    hardest[i] = hardest[j];
+    hardest[j] = temp;
+}
+
+static void sift_down(int i, int count){
+    while(2*i + 1 < count){
+        int child = 2*i + 1;
+        if(child + 1 < count && hardest[child + 1].cost < hardest[child].cost){
+            child++;
+        }
+        if(hardest[i].cost <= hardest[child].cost){
+            return;
+        }
+        swap_hard_graphs(i, child);
+        i = child;
+    }
+}
+
+void offer_hardest_graph(GRAPH graph, DEGREES out){
+    int i;
+    HARD_GRAPH *hg;
+#ifdef COUNT_SEARCH_NODES
+    double cost = (double) last_nodes;
+#else
+    double cost = last_time;
+#endif
+    
+    if(hardest == NULL) return;
+    
+    if(hardest_count < hardest_size){
+        i = hardest_count++;
+        hg = hardest + i;
+    } else if(cost > hardest[0].cost){
+        i = -1;
+        hg = hardest;
+    } else {
+        return;
+    }
+    
+    hg->cost = cost;
+    hg->number = input_graph_number();
+    hg->nodes = last_nodes;
+    hg->time = last_time;
+    hg->length = encode_watercluster_format(graph, out, hg->code);
+    
+    if(i < 0){
+        sift_down(0, hardest_count);
+    } else {
+        //sift up
+        while(i > 0 && hardest[(i-1)/2].cost > hardest[i].cost){
+            swap_hard_graphs(i, (i-1)/2);
+            i = (i-1)/2;
+        }
+    }
+}
+
+void write_hardest_graphs(){
+    int i;
+    FILE *f;
+    
+    if(hardest == NULL) return;
+    
+    f = fopen(hardest_filename, "w");
+    if(f == NULL){
+        fprintf(stderr, "Could not open %s to write the hardest graphs.\n", hardest_filename);
+        return;
+    }
+    
+    //heap sort: repeatedly move the easiest graph to the back
+    for(i = hardest_count - 1; i > 0; i--){
+        swap_hard_graphs(0, i);
+        sift_down(0, i);
+    }
+    
+    for(i = 0; i < hardest_count; i++){
+        fwrite(hardest[i].code, sizeof(unsigned char), hardest[i].length, f);
+        fprintf(stderr, "Hardest graph %d is graph %llu (nodes: %llu, time: %.9f)\n",
+                i + 1, hardest[i].number, hardest[i].nodes, hardest[i].time);
+    }
+    
+    fclose(f);
+    free(hardest);
+    hardest = NULL;
+}
+
+void graph_written(){
+    stats_graphs_written++;
+}
+
+void write_statistics(const char *tool){
+    int i;
+    FILE *f;
+
+    if(!enabled) return;
+
+    f = fopen(stats_filename, "w");
+    if(f == NULL){
+        fprintf(stderr, "Could not open %s to write statistics.\n", stats_filename);
+        return;
+    }
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"tool\": \"%s\",\n", tool);
+    fprintf(f, "  \"graphs\": {\n");
+    fprintf(f, "    \"read\": %llu,\n", stats_graphs_read);
+    fprintf(f, "    \"accepted\": %llu,\n", stats_graphs_accepted);
+    fprintf(f, "    \"rejected\": %llu,\n", stats_graphs_read - stats_graphs_accepted);
+    fprintf(f, "    \"written\": %llu\n", stats_graphs_written);
+    fprintf(f, "  },\n");
+    fprintf(f, "  \"rejections\": {");
+    for(i = 0; i < stage_count; i++){
+        fprintf(f, "%s\n    \"%s\": %llu", i ? "," : "", stage_names[i], stage_rejections[i]);
+    }
+    fprintf(f, "%s},\n", stage_count ? "\n  " : "");
+    fprintf(f, "  \"search\": {\n");
+#ifdef COUNT_SEARCH_NODES
+    fprintf(f, "    \"counted\": true,\n");
+#else
+    fprintf(f, "    \"counted\": false,\n");
+#endif
+    fprintf(f, "    \"nodes\": %llu,\n", nodes_at_last_graph);
+    fprintf(f, "    \"mean_nodes_per_graph\": %.3f,\n",
+            stats_graphs_read ? ((double) nodes_at_last_graph) / stats_graphs_read : 0.0);
+    fprintf(f, "    \"max_nodes_per_graph\": %llu,\n", max_nodes);
+    fprintf(f, "    \"max_nodes_graph\": %llu\n", max_nodes_graph);
+    fprintf(f, "  },\n");
+    fprintf(f, "  \"phases\": {\n");
+    for(i = 0; i < PHASE_COUNT; i++){
+        fprintf(f, "    \"%s\": {\"wall\": %.6f, \"cpu\": %.6f}%s\n",
+                phase_names[i], phase_wall[i], phase_cpu[i], i < PHASE_COUNT - 1 ? "," : "");
+    }
+    fprintf(f, "  },\n");
+    fprintf(f, "  \"total\": {\"wall\": %.6f, \"cpu\": %.6f}\n",
+            seconds(CLOCK_MONOTONIC) - run_wall_start,
+            seconds(CLOCK_PROCESS_CPUTIME_ID) - run_cpu_start);
+    fprintf(f, "}\n");
+
+    fclose(f);
+}
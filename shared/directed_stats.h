@@ -0,0 +1,147 @@
+/*
+ * File:   directed_stats.h
+ * Author: nvcleemp
+ *
+ * Created on October 18, 2026
+ */
+
+#ifndef DIRECTED_STATS_H
+#define	DIRECTED_STATS_H
+
+#include <stdio.h>
+#include "directed_base.h"
+
+/* The phases in which a tool spends its time. */
+typedef enum {
+    PHASE_DECODE,
+    PHASE_PREFILTER,
+    PHASE_SEARCH,
+    PHASE_ENCODE,
+    PHASE_COUNT
+} PHASE;
+
+#define MAX_STAGES 8
+
+/* Counting the nodes expanded by the depth-first searches is done in the
+ * innermost loops, so it is only compiled in when COUNT_SEARCH_NODES is
+ * defined (e.g. make CFLAGS="-O4 -DCOUNT_SEARCH_NODES"). Each thread has its
+ * own counter, so the searches can run in several threads.
+ */
+#ifdef COUNT_SEARCH_NODES
+extern __thread unsigned long long int search_nodes;
+#define COUNT_SEARCH_NODE() search_nodes++
+#else
+#define COUNT_SEARCH_NODE()
+#endif
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/**
+ * Enables the collection of statistics. Statistics are written as JSON to the
+ * given file when write_statistics() is called.
+ */
+void enable_statistics(char *filename);
+
+boolean statistics_enabled();
+
+/**
+ * Gives a name to a prefilter stage. Stages are numbered from 0 up to
+ * MAX_STAGES-1.
+ */
+void register_rejection_stage(int stage, const char *name);
+
+const char *phase_name(PHASE phase);
+
+/**
+ * Marks the start and end of a phase. The time is only measured when
+ * statistics are enabled, or when compiled with PROFILE_PHASES.
+ */
+void start_phase(PHASE phase);
+void stop_phase(PHASE phase);
+
+/**
+ * Marks that a graph was rejected by the given stage.
+ */
+void reject_at_stage(int stage);
+
+/**
+ * Marks the start of the processing of a graph.
+ */
+void start_graph();
+
+/**
+ * Marks the end of the processing of a graph. This collects the search effort
+ * for that graph.
+ */
+void graph_processed(boolean accepted);
+
+/**
+ * Returns the number of search nodes expanded for the current graph.
+ */
+unsigned long long int current_search_nodes();
+
+/**
+ * Adds the search nodes of the calling thread to the total. A thread that
+ * searches should call this before it ends.
+ */
+void merge_thread_search_nodes();
+
+/**
+ * Returns the search nodes of the calling thread and of all threads that were
+ * merged.
+ */
+unsigned long long int total_search_nodes();
+
+/**
+ * Returns the time in seconds spent on the last processed graph. This is only
+ * measured when statistics, hardness or the hardest graphs are enabled.
+ */
+double last_graph_time();
+
+/**
+ * Returns the number of search nodes expanded for the last processed graph.
+ */
+unsigned long long int last_graph_search_nodes();
+
+void enable_hardness();
+
+/**
+ * Prints the search nodes and time for the last processed graph as two tab
+ * separated columns (including the leading tab).
+ */
+void print_hardness(FILE *f);
+
+/**
+ * Enables keeping the size most expensive graphs. At the end these are written
+ * in watercluster format to the given file. The cost of a graph is the number
+ * of search nodes when these are counted and the time otherwise.
+ */
+void enable_hardest_graphs(int size, char *filename);
+
+/**
+ * Offers the last processed graph to the collection of hardest graphs.
+ */
+void offer_hardest_graph(GRAPH graph, DEGREES out);
+
+/**
+ * Writes the hardest graphs to the file passed to enable_hardest_graphs(),
+ * hardest first. Does nothing if this was not enabled.
+ */
+void write_hardest_graphs();
+
+void graph_written();
+
+/**
+ * Writes the collected statistics as JSON to the file that was passed to
+ * enable_statistics(). Does nothing if statistics are not enabled.
+ */
+void write_statistics(const char *tool);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* DIRECTED_STATS_H */
+
@@ -0,0 +1,105 @@
+/*
+ * File:   directed_z6.c
+ * Author: nvcleemp
+ *
+ * Created on October 18, 2026
+ */
+
+#include "directed_z6.h"
+#include "directed_quartic.h"
+
+static inline boolean satisfies_conditions_single_vertex(DEGREES out, DEGREES in, Z6_KIND kind, int v){
+    return kind != Z6_QUARTIC || (out[v]==2 && in[v]==2);
+}
+
+static inline boolean satisfies_conditions_all_vertices(DEGREES out, DEGREES in, Z6_KIND kind, int x, int y, int z){
+    return kind != Z6_NON_QUARTIC || (out[x] + out[y] + out[z] + in[x] + in[y] + in[z] > 12);
+}
+
+/**
+ * Returns the number of copies of Z6 with the directed 3-cycle x -> y -> z -> x.
+ * The ears of each arc of the 3-cycle are found as the intersection of an
+ * out-neighbourhood and an in-neighbourhood. A copy needs three different
+ * ears, so the triples in which two ears coincide are subtracted: each
+ * intersection of two sets of ears is subtracted once, and the common ears of
+ * all three arcs are subtracted three times, so these are added twice.
+ */
+static inline unsigned long long int count_z6_at_3_cycle(BITSET out_masks[], BITSET in_masks[], int x, int y, int z){
+    BITSET others = ~(BIT(x) | BIT(y) | BIT(z));
+    BITSET ears_x = out_masks[x] & in_masks[z] & others; //x -> x' -> z
+    BITSET ears_y = out_masks[y] & in_masks[x] & others; //y -> y' -> x
+    BITSET ears_z = out_masks[z] & in_masks[y] & others; //z -> z' -> y
+    unsigned long long int a = __builtin_popcountll(ears_x);
+    unsigned long long int b = __builtin_popcountll(ears_y);
+    unsigned long long int c = __builtin_popcountll(ears_z);
+    
+    if(!a || !b || !c){
+        return 0;
+    }
+    return a * b * c
+            - __builtin_popcountll(ears_x & ears_y) * c
+            - __builtin_popcountll(ears_x & ears_z) * b
+            - __builtin_popcountll(ears_y & ears_z) * a
+            + 2 * __builtin_popcountll(ears_x & ears_y & ears_z);
+}
+
+//directed 3-cycle is x -> y -> z -> x
+boolean is_z6(GRAPH graph, DEGREES out, DEGREES in, int x, int y, int z){
+    BITSET out_masks[MAXN + 1], in_masks[MAXN + 1];
+    neighbourhood_masks(graph, out, out_masks, in_masks);
+    return count_z6_at_3_cycle(out_masks, in_masks, x, y, z) > 0;
+}
+
+/**
+ * Counts the copies of Z6, or only checks whether there is one if
+ * first_only is TRUE.
+ */
+static unsigned long long int find_z6(GRAPH graph, DEGREES out, DEGREES in, Z6_KIND kind, boolean first_only){
+    BITSET out_masks[MAXN + 1], in_masks[MAXN + 1];
+    int x;
+    unsigned long long int count = 0;
+
+    QUARTIC_GRAPH q;
+    if(make_quartic_graph(graph, out, &q)){
+        //every 3-cycle has only vertices of degree 2
+        return kind == Z6_NON_QUARTIC ? 0 : quartic_count_z6(&q, first_only);
+    }
+
+    int order = graph[0][0];
+    neighbourhood_masks(graph, out, out_masks, in_masks);
+
+    //check all 3-cycles (we impose that x is the smallest of the three vertices)
+    for(x = 1; x <= order; x++){
+        if(!satisfies_conditions_single_vertex(out, in, kind, x)) continue;
+        BITSET larger = ~(BIT(x + 1) - 1);
+        BITSET ys = out_masks[x] & larger;
+        while(ys){
+            int y = __builtin_ctzll(ys);
+            ys &= ys - 1;
+            if(!satisfies_conditions_single_vertex(out, in, kind, y)) continue;
+            //the vertices z that close a 3-cycle x -> y -> z -> x
+            BITSET zs = out_masks[y] & in_masks[x] & larger;
+            while(zs){
+                int z = __builtin_ctzll(zs);
+                zs &= zs - 1;
+                if(satisfies_conditions_single_vertex(out, in, kind, z) &&
+                        satisfies_conditions_all_vertices(out, in, kind, x, y, z)){
+                    count += count_z6_at_3_cycle(out_masks, in_masks, x, y, z);
+                    if(first_only && count){
+                        return count;
+                    }
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+boolean has_z6(GRAPH graph, DEGREES out, DEGREES in, Z6_KIND kind){
+    return find_z6(graph, out, in, kind, TRUE) > 0;
+}
+
+unsigned long long int count_z6(GRAPH graph, DEGREES out, DEGREES in, Z6_KIND kind){
+    return find_z6(graph, out, in, kind, FALSE);
+}
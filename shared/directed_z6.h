@@ -0,0 +1,48 @@
+/*
+ * File:   directed_z6.h
+ * Author: nvcleemp
+ *
+ * Created on October 18, 2026
+ */
+
+#ifndef DIRECTED_Z6_H
+#define	DIRECTED_Z6_H
+
+#include "directed_base.h"
+
+/* A copy of Z6 is a directed 3-cycle x -> y -> z -> x together with three
+ * further vertices that each form a directed 2-path with one arc of the
+ * 3-cycle: x -> x' -> z, y -> y' -> x and z -> z' -> y.
+ */
+
+/* The copies of Z6 that are taken into account. */
+typedef enum {
+    Z6_ANY,
+    Z6_QUARTIC, //all vertices of the 3-cycle have in-degree and out-degree 2
+    Z6_NON_QUARTIC //some vertex of the 3-cycle has a larger degree
+} Z6_KIND;
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/**
+ * Returns TRUE if the directed 3-cycle x -> y -> z -> x is part of a copy of
+ * Z6.
+ */
+boolean is_z6(GRAPH graph, DEGREES out, DEGREES in, int x, int y, int z);
+
+boolean has_z6(GRAPH graph, DEGREES out, DEGREES in, Z6_KIND kind);
+
+/**
+ * Returns the number of copies of Z6, i.e., the number of ways to choose a
+ * directed 3-cycle and three different ears for its arcs.
+ */
+unsigned long long int count_z6(GRAPH graph, DEGREES out, DEGREES in, Z6_KIND kind);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* DIRECTED_Z6_H */
+
@@ -0,0 +1,56 @@
+#!/bin/sh
+
+# Runs the hypospanning tools and directed_invariant on reproducible random
+# workloads and reports the throughput in graphs per second.
+#
+# Usage: directed_bench.sh [build directory]
+
+BUILD=${1:-build}
+WORK=$BUILD/bench
+mkdir -p "$WORK"
+
+now() {
+    date +%s.%N
+}
+
+# generate name type options...
+generate() {
+    name=$1
+    shift
+    "$BUILD/directed_generate" "$@" -s 20190205 > "$WORK/$name.wcf" 2>/dev/null
+    "$BUILD/directed_generate" "$@" -s 20190205 -D > "$WORK/$name.d6" 2>/dev/null
+}
+
+generate digraph    digraph    -n 12 -p 0.35 -c 10000
+generate oriented   oriented   -n 12 -p 0.6  -c 10000
+generate regular    regular    -n 16 -k 2    -c 20000
+generate tournament tournament -n 10         -c 2000
+
+# run label workload count command...
+run() {
+    label=$1
+    workload=$2
+    count=$3
+    shift 3
+    start=$(now)
+    "$@" < "$WORK/$workload" > /dev/null 2>&1
+    end=$(now)
+    awk -v l="$label" -v w="$workload" -v c="$count" -v s="$start" -v e="$end" \
+        'BEGIN { t = e - s; if (t <= 0) t = 1e-9; printf "%-48s %-16s %10.3f s %14.1f graphs/s\n", l, w, t, c / t }'
+}
+
+printf "%-48s %-16s %12s %21s\n" "tool" "workload" "time" "throughput"
+
+for workload in digraph:10000 oriented:10000 regular:20000 tournament:2000; do
+    name=${workload%%:*}
+    count=${workload##*:}
+    for tool in directed_is_hamiltonian directed_is_hypohamiltonian directed_is_hypotraceable directed_is_hypospanning \
+            directed_has_suitable_3_cycle directed_all_suitable_3_cycles \
+            directed_all_vertex_deleted_hamiltonian_cycles directed_has_z6 directed_all_z6; do
+        run "$tool" "$name.wcf" "$count" "$BUILD/$tool"
+    done
+    run "directed_is_hypohamiltonian -D" "$name.d6" "$count" "$BUILD/directed_is_hypohamiltonian" -D
+    for invariant in arcs sink source; do
+        run "directed_invariant $invariant" "$name.wcf" "$count" "$BUILD/directed_invariant" "$invariant"
+    done
+done
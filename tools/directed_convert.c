@@ -0,0 +1,140 @@
+/*
+ *
+ * Copyright (C) 2026 Ghent University.
+ */
+
+/* This program reads directed graphs from standard in and writes them in
+ * another format to standard out.
+ *
+ *
+ * Compile with:
+ *
+ *     cc -o directed_convert -O4 directed_convert.c
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+
+#include "../shared/directed_base.h"
+#include "../shared/directed_io.h"
+
+unsigned long long int graph_count = 0;
+
+//====================== USAGE =======================
+
+void help(char *name) {
+    fprintf(stderr, "Converts directed graphs between formats.\n\n");
+    fprintf(stderr, "Usage\n=====\n");
+    fprintf(stderr, " %s [options]\n\n", name);
+    fprintf(stderr, "Possible formats are:\n");
+    fprintf(stderr, "  * wcf: watercluster format\n");
+    fprintf(stderr, "  * d6: digraph6 format\n");
+    fprintf(stderr, "  * bits: bitset container with a fixed size per graph\n");
+    fprintf(stderr, "  * adj: adjacency lists in text, e.g. \"1: 2, 3\", with an empty line\n");
+    fprintf(stderr, "         after each graph (the output of directed_show can also be read)\n");
+    fprintf(stderr, "  * multi: multi_code; graphs are read as symmetric digraphs and the\n");
+    fprintf(stderr, "           underlying undirected graph is written\n");
+    fprintf(stderr, "  * planar: planar_code; input only, graphs are read as symmetric digraphs\n");
+    fprintf(stderr, "\nThis program can handle graphs up to %d vertices. Recompile with a larger\n", MAXN);
+    fprintf(stderr, "value for MAXN if you need to handle larger graphs.\n\n");
+    fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -i format, --input-format format\n");
+    fprintf(stderr, "       Reads graphs in the given format (default: wcf).\n");
+    fprintf(stderr, "    -o format, --output-format format\n");
+    fprintf(stderr, "       Writes graphs in the given format (default: wcf).\n");
+    fprintf(stderr, "    -0, --zero-based\n");
+    fprintf(stderr, "       Vertices in adjacency lists are numbered starting from 0.\n");
+    fprintf(stderr, "    -m, --in-masks\n");
+    fprintf(stderr, "       Also stores the in-masks when writing a bitset container.\n");
+    help_shared_io_options(stderr);
+    fprintf(stderr, "    -h, --help\n");
+    fprintf(stderr, "       Print this help and return.\n");
+}
+
+void usage(char *name) {
+    fprintf(stderr, "Usage: %s [options]\n", name);
+    fprintf(stderr, "For more information type: %s -h \n\n", name);
+}
+
+/*
+ *
+ */
+int main(int argc, char** argv) {
+
+    GRAPH graph;
+    DEGREES out;
+    DEGREES in;
+
+    GRAPH_READER read_graph = read_graph_from_watercluster_file;
+    GRAPH_WRITER write_graph = write_watercluster_format;
+
+    /*=========== commandline parsing ===========*/
+
+    int c;
+    char *name = argv[0];
+    static struct option long_options[] = {
+        {"input-format", required_argument, NULL, 'i'},
+        {"output-format", required_argument, NULL, 'o'},
+        {"zero-based", no_argument, NULL, '0'},
+        {"in-masks", no_argument, NULL, 'm'},
+        {"help", no_argument, NULL, 'h'},
+        SHARED_IO_OPTIONS,
+        {NULL, 0, NULL, 0}
+    };
+    int option_index = 0;
+
+    while ((c = getopt_long(argc, argv, "hi:o:0m", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 'i':
+                read_graph = graph_reader_for_format(optarg);
+                if(read_graph == NULL){
+                    fprintf(stderr, "Unknown input format: %s -- exiting!\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'o':
+                write_graph = graph_writer_for_format(optarg);
+                if(write_graph == NULL){
+                    fprintf(stderr, "Unknown output format: %s -- exiting!\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case '0':
+                set_adjlist_zero_based(TRUE);
+                break;
+            case 'm':
+                set_bitset_in_masks(TRUE);
+                break;
+            case SELECT_RANGE_OPTION:
+            case SELECT_IDS_OPTION:
+            case SELECT_INDEX_OPTION:
+            case COMPRESS_OPTION:
+            case COMPRESS_THREADS_OPTION:
+                handle_shared_io_option(c, optarg);
+                break;
+            case 'h':
+                help(name);
+                return EXIT_SUCCESS;
+            case '?':
+                usage(name);
+                return EXIT_FAILURE;
+            default:
+                fprintf(stderr, "Illegal option %c.\n", c);
+                usage(name);
+                return EXIT_FAILURE;
+        }
+    }
+
+    while (read_graph(stdin, graph, out, in)) {
+        graph_count++;
+        write_graph(graph, out, stdout);
+    }
+
+    fprintf(stderr, "Converted %llu graph%s.\n", graph_count, graph_count==1 ? "" : "s");
+
+    return (EXIT_SUCCESS);
+}
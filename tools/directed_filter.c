@@ -0,0 +1,352 @@
+/*
+ *
+ * Copyright (C) 2026 Ghent University.
+ */
+
+/* This program reads directed graphs in watercluster or digraph6 format from
+ * standard in and evaluates an expression over invariants and properties for
+ * each of them, e.g.
+ *
+ *     directed_filter -f 'hypoham && !z6 && arcs>=40'
+ *
+ * Each graph is decoded once, and the cheapest parts of the expression are
+ * evaluated first, so this replaces a pipeline of several filters.
+ *
+ *
+ * Compile with:
+ *
+ *     cc -o directed_filter -O4 directed_filter.c
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <string.h>
+
+#include "../shared/directed_base.h"
+#include "../shared/directed_io.h"
+#include "../shared/directed_stats.h"
+#include "../shared/directed_invariants.h"
+#include "../shared/directed_expression.h"
+
+unsigned long long int graph_count = 0;
+unsigned long long int filtered_count = 0;
+
+//the terms that are always computed and printed in the table
+boolean column[MAX_EXPRESSION_TERMS];
+
+void add_columns(EXPRESSION *expression, char *list){
+    char *name = strtok(list, ",");
+    while(name != NULL){
+        const INVARIANT *invariant = find_invariant(name);
+        if(invariant == NULL){
+            fprintf(stderr, "Unknown invariant %s -- exiting!\n", name);
+            exit(EXIT_FAILURE);
+        }
+        column[expression_term(expression, invariant)] = TRUE;
+        name = strtok(NULL, ",");
+    }
+}
+
+void print_table_header(FILE *f, EXPRESSION *expression){
+    int i;
+    fprintf(f, "# graph\tresult");
+    for(i = 0; i < expression_term_count(expression); i++){
+        fprintf(f, "\t%s", expression_term_invariant(expression, i)->name);
+    }
+    fprintf(f, "\n");
+}
+
+/**
+ * Prints the number of the graph, the value of the expression and the value of
+ * each term. Terms that were not needed to evaluate the expression are printed
+ * as -.
+ */
+void print_table_row(FILE *f, EXPRESSION *expression, boolean value, GRAPH graph, DEGREES out, DEGREES in){
+    int i;
+    fprintf(f, "%llu\t%d", input_graph_number(), value ? 1 : 0);
+    for(i = 0; i < expression_term_count(expression); i++){
+        if(expression_term_evaluated(expression, i)){
+            fprintf(f, "\t%d", expression_term_value(expression, i, graph, out, in));
+        } else {
+            fprintf(f, "\t-");
+        }
+    }
+    fprintf(f, "\n");
+}
+
+//====================== USAGE =======================
+
+void help(char *name) {
+    fprintf(stderr, "Evaluates an expression over invariants for directed graphs.\n\n");
+    fprintf(stderr, "Usage\n=====\n");
+    fprintf(stderr, " %s [options] expression\n\n", name);
+    fprintf(stderr, "An expression combines invariants with the comparisons ==, !=, <, <=, > and\n");
+    fprintf(stderr, ">=, the operators !, && and ||, and parentheses, e.g.\n\n");
+    fprintf(stderr, "    hypoham && !z6 && arcs>=40\n\n");
+    fprintf(stderr, "An invariant on its own is true if its value is not 0. The cheapest parts\n");
+    fprintf(stderr, "of the expression are evaluated first, and evaluation stops as soon as the\n");
+    fprintf(stderr, "result is known.\n\n");
+    fprintf(stderr, "By default a table is printed with for each graph its number, the value of\n");
+    fprintf(stderr, "the expression and the values of the invariants (or - when an invariant was\n");
+    fprintf(stderr, "not needed).\n");
+    fprintf(stderr, "\nThis program can handle graphs up to %d vertices. Recompile with a larger\n", MAXN);
+    fprintf(stderr, "value for MAXN if you need to handle larger graphs.\n\n");
+    fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -l, --list\n");
+    fprintf(stderr, "       Print a list of available invariants and return.\n");
+    fprintf(stderr, "    -f, --filter\n");
+    fprintf(stderr, "       Filter graphs for which the expression is true.\n");
+    fprintf(stderr, "    -i, --invert\n");
+    fprintf(stderr, "       Invert the filter.\n");
+    fprintf(stderr, "    -t file, --table file\n");
+    fprintf(stderr, "       Write the table to the given file instead of standard out. This can\n");
+    fprintf(stderr, "       be combined with filtering.\n");
+    fprintf(stderr, "    -c list, --columns list\n");
+    fprintf(stderr, "       Always compute the comma-separated invariants in the list and add them\n");
+    fprintf(stderr, "       to the table.\n");
+    fprintf(stderr, "    -v, --verbose\n");
+    fprintf(stderr, "       Print the expression in the order in which it is evaluated.\n");
+    fprintf(stderr, "    -u n, --update n\n");
+    fprintf(stderr, "       Give an update every n graphs.\n");
+    fprintf(stderr, "    -D, --digraph6\n");
+    fprintf(stderr, "       Reads graphs in digraph6 format instead of watercluster format.\n");
+    fprintf(stderr, "    -O format, --output-format format\n");
+    fprintf(stderr, "       Writes graphs in the given format: wcf (watercluster), d6 (digraph6),\n");
+    fprintf(stderr, "       bits (bitset container), adj (adjacency lists) or multi (multi_code).\n");
+    fprintf(stderr, "       By default, or with input, the graphs are copied unchanged from the\n");
+    fprintf(stderr, "       input.\n");
+    fprintf(stderr, "    --stats=file\n");
+    fprintf(stderr, "       Write statistics about this run in JSON format to the given file.\n");
+    fprintf(stderr, "    --hardest=k\n");
+    fprintf(stderr, "       Write the k graphs that were most expensive to evaluate to a file.\n");
+    fprintf(stderr, "    --hardest-file=file\n");
+    fprintf(stderr, "       The file to which the hardest graphs are written (default: hardest.wcf).\n");
+    help_shared_io_options(stderr);
+    fprintf(stderr, "    -h, --help\n");
+    fprintf(stderr, "       Print this help and return.\n");
+}
+
+void usage(char *name) {
+    fprintf(stderr, "Usage: %s [options] expression\n", name);
+    fprintf(stderr, "For more information type: %s -h \n\n", name);
+}
+
+/*
+ *
+ */
+int main(int argc, char** argv) {
+
+    GRAPH graph;
+    DEGREES out;
+    DEGREES in;
+
+    boolean do_filtering = FALSE;
+    boolean invert = FALSE;
+    boolean verbose = FALSE;
+
+    char *columns = NULL;
+    char *table_file = NULL;
+    FILE *table = NULL;
+
+    boolean (*read_graph)(FILE *, GRAPH, DEGREES, DEGREES) = read_graph_from_watercluster_file;
+    void (*write_graph)(GRAPH, DEGREES, FILE *) = write_input_graph;
+
+    int update = 0;
+
+    int hardest_count = 0;
+    char *hardest_file = "hardest.wcf";
+
+    /*=========== commandline parsing ===========*/
+
+    int c;
+    char *name = argv[0];
+    static struct option long_options[] = {
+        {"stats", required_argument, NULL, 0},
+        {"hardest", required_argument, NULL, 0},
+        {"hardest-file", required_argument, NULL, 0},
+        {"list", no_argument, NULL, 'l'},
+        {"filter", no_argument, NULL, 'f'},
+        {"invert", no_argument, NULL, 'i'},
+        {"table", required_argument, NULL, 't'},
+        {"columns", required_argument, NULL, 'c'},
+        {"verbose", no_argument, NULL, 'v'},
+        {"update", required_argument, NULL, 'u'},
+        {"digraph6", no_argument, NULL, 'D'},
+        {"output-format", required_argument, NULL, 'O'},
+        {"help", no_argument, NULL, 'h'},
+        SHARED_IO_OPTIONS,
+        {NULL, 0, NULL, 0}
+    };
+    int option_index = 0;
+
+    while ((c = getopt_long(argc, argv, "hlfit:c:vu:DO:", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 0:
+                switch(option_index) {
+                    case 0:
+                        enable_statistics(optarg);
+                        break;
+                    case 1:
+                        hardest_count = atoi(optarg);
+                        break;
+                    case 2:
+                        hardest_file = optarg;
+                        break;
+                    default:
+                        fprintf(stderr, "Illegal option index %d.\n", option_index);
+                        usage(name);
+                        return EXIT_FAILURE;
+                }
+                break;
+            case 'l':
+                fprintf(stderr, "Available invariants are\n");
+                list_invariants(stderr);
+                return EXIT_SUCCESS;
+            case 'f':
+                do_filtering = TRUE;
+                break;
+            case 'i':
+                invert = TRUE;
+                break;
+            case 't':
+                table_file = optarg;
+                break;
+            case 'c':
+                columns = optarg;
+                break;
+            case 'v':
+                verbose = TRUE;
+                break;
+            case 'u':
+                update = atoi(optarg);
+                break;
+            case 'D':
+                read_graph = read_graph_from_digraph6_file;
+                break;
+            case 'O':
+                write_graph = input_writer_for_format(optarg);
+                if(write_graph == NULL){
+                    fprintf(stderr, "Unknown output format: %s -- exiting!\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case SELECT_RANGE_OPTION:
+            case SELECT_IDS_OPTION:
+            case SELECT_INDEX_OPTION:
+            case COMPRESS_OPTION:
+            case COMPRESS_THREADS_OPTION:
+                handle_shared_io_option(c, optarg);
+                break;
+            case 'h':
+                help(name);
+                return EXIT_SUCCESS;
+            case '?':
+                usage(name);
+                return EXIT_FAILURE;
+            default:
+                fprintf(stderr, "Illegal option %c.\n", c);
+                usage(name);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if(argc - optind != 1){
+        fprintf(stderr, "Please specify one expression -- exiting!\n");
+        usage(name);
+        return EXIT_FAILURE;
+    }
+    if(!do_filtering && update){
+        fprintf(stderr, "Updates are only available when filtering is enabled.\n");
+        update = 0;
+    }
+
+    EXPRESSION *expression = parse_expression(argv[optind]);
+    if(columns != NULL){
+        add_columns(expression, columns);
+    }
+    if(verbose){
+        fprintf(stderr, "Evaluating ");
+        print_expression(stderr, expression);
+    }
+
+    if(table_file != NULL){
+        table = fopen(table_file, "w");
+        if(table == NULL){
+            fprintf(stderr, "Could not open %s -- exiting!\n", table_file);
+            return EXIT_FAILURE;
+        }
+    } else if(!do_filtering){
+        table = stdout;
+    }
+    if(table != NULL){
+        print_table_header(table, expression);
+    }
+
+    if(hardest_count){
+        enable_hardest_graphs(hardest_count, hardest_file);
+    }
+
+    int i;
+    start_phase(PHASE_DECODE);
+    while (read_graph(stdin, graph, out, in)) {
+        stop_phase(PHASE_DECODE);
+        graph_count++;
+
+        start_graph();
+        start_phase(PHASE_SEARCH);
+        clear_expression_values(expression);
+        boolean value = evaluate_expression(expression, graph, out, in);
+        for(i = 0; i < expression_term_count(expression); i++){
+            if(column[i]){
+                expression_term_value(expression, i, graph, out, in);
+            }
+        }
+        stop_phase(PHASE_SEARCH);
+        graph_processed(value);
+        offer_hardest_graph(graph, out);
+
+        if(table != NULL){
+            print_table_row(table, expression, value, graph, out, in);
+        }
+        if(do_filtering){
+            if((invert && !value) || (!invert && value)){
+                filtered_count++;
+                start_phase(PHASE_ENCODE);
+                write_graph(graph, out, stdout);
+                stop_phase(PHASE_ENCODE);
+                graph_written();
+            }
+            if(update && !(graph_count % update)){
+                fprintf(stderr, "Read: %llu. Filtered: %llu\n", graph_count, filtered_count);
+            }
+        }
+        start_phase(PHASE_DECODE);
+    }
+    stop_phase(PHASE_DECODE);
+
+    if(table != NULL && table != stdout){
+        fclose(table);
+    }
+
+    fprintf(stderr, "Read %llu graph%s.\n", graph_count, graph_count==1 ? "" : "s");
+    for(i = 0; i < expression_term_count(expression); i++){
+        unsigned long long int evaluations = expression_term_evaluations(expression, i);
+        fprintf(stderr, "Computed %s for %llu graph%s.\n",
+                expression_term_invariant(expression, i)->name,
+                evaluations, evaluations==1 ? "" : "s");
+    }
+    if(do_filtering){
+        fprintf(stderr, "Filtered %llu graph%s.\n", filtered_count, filtered_count==1 ? "" : "s");
+    }
+
+    free_expression(expression);
+
+    write_hardest_graphs();
+    write_statistics("directed_filter");
+
+    return (EXIT_SUCCESS);
+}
+
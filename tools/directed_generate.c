@@ -0,0 +1,312 @@
+/*
+ *
+ * Copyright (C) 2026 Ghent University.
+ */
+
+/* This program generates random directed graphs and writes them in
+ * watercluster or digraph6 format to standard out. The same seed always gives
+ * the same graphs, so the output can be used as a reproducible workload.
+ *
+ *
+ * Compile with:
+ *
+ *     cc -o directed_generate -O4 directed_generate.c
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <string.h>
+
+#include "../shared/directed_base.h"
+#include "../shared/directed_io.h"
+
+//======================== RANDOM ==============================
+
+/* We use our own generator (splitmix64) instead of rand(), so the generated
+ * graphs do not depend on the C library.
+ */
+unsigned long long int random_state;
+
+unsigned long long int next_random(){
+    unsigned long long int z = (random_state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Returns a random integer in the range [0, bound).
+ */
+int random_int(int bound){
+    return (int)(next_random() % bound);
+}
+
+/**
+ * Returns a random double in the range [0, 1).
+ */
+double random_double(){
+    return (next_random() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+//======================== GENERATORS ==============================
+
+void random_digraph(GRAPH graph, DEGREES out, DEGREES in, int order, double density, int degree){
+    int i, j;
+
+    prepare_graph(graph, out, in, order);
+
+    for(i = 1; i <= order; i++){
+        for(j = 1; j <= order; j++){
+            if(i != j && random_double() < density){
+                add_arc(graph, out, in, i, j);
+            }
+        }
+    }
+}
+
+void random_oriented_graph(GRAPH graph, DEGREES out, DEGREES in, int order, double density, int degree){
+    int i, j;
+
+    prepare_graph(graph, out, in, order);
+
+    for(i = 1; i <= order; i++){
+        for(j = i + 1; j <= order; j++){
+            if(random_double() < density){
+                if(random_int(2)){
+                    add_arc(graph, out, in, i, j);
+                } else {
+                    add_arc(graph, out, in, j, i);
+                }
+            }
+        }
+    }
+}
+
+void random_tournament(GRAPH graph, DEGREES out, DEGREES in, int order, double density, int degree){
+    random_oriented_graph(graph, out, in, order, 1.0, degree);
+}
+
+/**
+ * Tries to add a random permutation without fixed points to the arcs stored in
+ * the adjacency matrix, such that no arc is added twice.
+ */
+boolean add_random_permutation(boolean adjacency[MAXN+1][MAXN+1], int order){
+    int permutation[MAXN+1];
+    int i, j, attempt;
+
+    for(attempt = 0; attempt < 1000; attempt++){
+        for(i = 1; i <= order; i++){
+            permutation[i] = i;
+        }
+        //Fisher-Yates shuffle
+        for(i = order; i > 1; i--){
+            j = 1 + random_int(i);
+            int temp = permutation[i];
+            permutation[i] = permutation[j];
+            permutation[j] = temp;
+        }
+
+        i = 1;
+        while(i <= order && permutation[i] != i && !adjacency[i][permutation[i]]) i++;
+
+        if(i > order){
+            for(i = 1; i <= order; i++){
+                adjacency[i][permutation[i]] = TRUE;
+            }
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * Generates a random digraph in which every vertex has in-degree and
+ * out-degree equal to degree. For large degrees the complement of a random
+ * regular digraph of degree order - 1 - degree is used.
+ */
+void random_regular_digraph(GRAPH graph, DEGREES out, DEGREES in, int order, double density, int degree){
+    boolean adjacency[MAXN+1][MAXN+1];
+    int i, j, k;
+    boolean complement = 2*degree > order - 1;
+    int factors = complement ? order - 1 - degree : degree;
+
+    do {
+        for(i = 1; i <= order; i++){
+            for(j = 1; j <= order; j++){
+                adjacency[i][j] = FALSE;
+            }
+        }
+        k = 0;
+        while(k < factors && add_random_permutation(adjacency, order)) k++;
+    } while (k < factors);
+
+    prepare_graph(graph, out, in, order);
+
+    for(i = 1; i <= order; i++){
+        for(j = 1; j <= order; j++){
+            if(i != j && adjacency[i][j] != complement){
+                add_arc(graph, out, in, i, j);
+            }
+        }
+    }
+}
+
+//====================== USAGE =======================
+
+void help(char *name) {
+    fprintf(stderr, "Generates random directed graphs.\n\n");
+    fprintf(stderr, "Usage\n=====\n");
+    fprintf(stderr, " %s type [options]\n\n", name);
+    fprintf(stderr, "Possible types are:\n");
+    fprintf(stderr, "  * digraph: every arc is present with probability p\n");
+    fprintf(stderr, "  * oriented: every edge is present with probability p and gets a random\n");
+    fprintf(stderr, "              orientation\n");
+    fprintf(stderr, "  * regular: every vertex has in-degree and out-degree k\n");
+    fprintf(stderr, "  * tournament: every edge is present and gets a random orientation\n");
+    fprintf(stderr, "\nThis program can handle graphs up to %d vertices. Recompile with a larger\n", MAXN);
+    fprintf(stderr, "value for MAXN if you need to handle larger graphs.\n\n");
+    fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -n #, --order #\n");
+    fprintf(stderr, "       The number of vertices (default: 10).\n");
+    fprintf(stderr, "    -c #, --count #\n");
+    fprintf(stderr, "       The number of graphs to generate (default: 1).\n");
+    fprintf(stderr, "    -s #, --seed #\n");
+    fprintf(stderr, "       The seed for the random generator (default: 1).\n");
+    fprintf(stderr, "    -p #, --density #\n");
+    fprintf(stderr, "       The probability that an arc or edge is present (default: 0.5).\n");
+    fprintf(stderr, "    -k #, --degree #\n");
+    fprintf(stderr, "       The in-degree and out-degree for regular digraphs (default: 2).\n");
+    fprintf(stderr, "    -D, --digraph6\n");
+    fprintf(stderr, "       Writes graphs in digraph6 format instead of watercluster format.\n");
+    fprintf(stderr, "    -O format, --output-format format\n");
+    fprintf(stderr, "       Writes graphs in the given format: wcf (watercluster, default), d6\n");
+    fprintf(stderr, "       (digraph6), bits (bitset container), adj (adjacency lists) or multi\n");
+    fprintf(stderr, "       (multi_code).\n");
+    fprintf(stderr, "    -h, --help\n");
+    fprintf(stderr, "       Print this help and return.\n");
+}
+
+void usage(char *name) {
+    fprintf(stderr, "Usage: %s type [options]\n", name);
+    fprintf(stderr, "For more information type: %s -h \n\n", name);
+}
+
+/*
+ *
+ */
+int main(int argc, char** argv) {
+
+    GRAPH graph;
+    DEGREES out;
+    DEGREES in;
+
+    int order = 10;
+    unsigned long long int count = 1;
+    unsigned long long int seed = 1;
+    double density = 0.5;
+    int degree = 2;
+
+    void (*write_graph)(GRAPH, DEGREES, FILE *) = write_watercluster_format;
+    void (*generate_graph)(GRAPH, DEGREES, DEGREES, int, double, int) = NULL;
+
+    /*=========== commandline parsing ===========*/
+
+    int c;
+    char *name = argv[0];
+    static struct option long_options[] = {
+        {"order", required_argument, NULL, 'n'},
+        {"count", required_argument, NULL, 'c'},
+        {"seed", required_argument, NULL, 's'},
+        {"density", required_argument, NULL, 'p'},
+        {"degree", required_argument, NULL, 'k'},
+        {"digraph6", no_argument, NULL, 'D'},
+        {"output-format", required_argument, NULL, 'O'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int option_index = 0;
+
+    while ((c = getopt_long(argc, argv, "hn:c:s:p:k:DO:", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 'n':
+                order = atoi(optarg);
+                break;
+            case 'c':
+                count = strtoull(optarg, NULL, 10);
+                break;
+            case 's':
+                seed = strtoull(optarg, NULL, 10);
+                break;
+            case 'p':
+                density = atof(optarg);
+                break;
+            case 'k':
+                degree = atoi(optarg);
+                break;
+            case 'D':
+                write_graph = write_digraph6_format;
+                break;
+            case 'O':
+                write_graph = graph_writer_for_format(optarg);
+                if(write_graph == NULL){
+                    fprintf(stderr, "Unknown output format: %s -- exiting!\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'h':
+                help(name);
+                return EXIT_SUCCESS;
+            case '?':
+                usage(name);
+                return EXIT_FAILURE;
+            default:
+                fprintf(stderr, "Illegal option %c.\n", c);
+                usage(name);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if(argc - optind < 1){
+        fprintf(stderr, "Please specify the type of graphs -- exiting!\n");
+        usage(name);
+        return EXIT_FAILURE;
+    }
+
+    if(strcmp(argv[optind], "digraph")==0){
+        generate_graph = random_digraph;
+    } else if(strcmp(argv[optind], "oriented")==0){
+        generate_graph = random_oriented_graph;
+    } else if(strcmp(argv[optind], "regular")==0){
+        generate_graph = random_regular_digraph;
+    } else if(strcmp(argv[optind], "tournament")==0){
+        generate_graph = random_tournament;
+    } else {
+        fprintf(stderr, "Unknown type: %s -- exiting!\n", argv[optind]);
+        usage(name);
+        return EXIT_FAILURE;
+    }
+
+    if(order < 1 || order > MAXN){
+        fprintf(stderr, "The order should be between 1 and %d -- exiting!\n", MAXN);
+        return EXIT_FAILURE;
+    }
+    if(generate_graph == random_regular_digraph && (degree < 0 || degree >= order)){
+        fprintf(stderr, "The degree should be between 0 and %d -- exiting!\n", order - 1);
+        return EXIT_FAILURE;
+    }
+
+    random_state = seed;
+
+    unsigned long long int i;
+    for(i = 0; i < count; i++){
+        generate_graph(graph, out, in, order, density, degree);
+        write_graph(graph, out, stdout);
+    }
+
+    fprintf(stderr, "Generated %llu graph%s.\n", count, count==1 ? "" : "s");
+
+    return (EXIT_SUCCESS);
+}
@@ -0,0 +1,126 @@
+/*
+ *
+ * Copyright (C) 2026 Ghent University.
+ */
+
+/* This program reads directed graphs in watercluster or digraph6 format from
+ * standard in and writes an index with the offset of each graph to standard
+ * out. Other programs can use this index with the option --index to jump
+ * directly to the graphs selected with --range or --ids.
+ *
+ * The input should be a file (not a pipe) for the offsets to be meaningful.
+ *
+ *
+ * Compile with:
+ *
+ *     cc -o directed_index -O4 directed_index.c
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+
+#include "../shared/directed_base.h"
+#include "../shared/directed_io.h"
+
+unsigned long long int graph_count = 0;
+
+//====================== USAGE =======================
+
+void help(char *name) {
+    fprintf(stderr, "Creates an index of a file with directed graphs.\n\n");
+    fprintf(stderr, "Usage\n=====\n");
+    fprintf(stderr, " %s [options] < graphs.wcf > graphs.wcf.idx\n\n", name);
+    fprintf(stderr, "The index contains the offset of each graph in the file. It can be used by\n");
+    fprintf(stderr, "the other programs with the option --index.\n");
+    fprintf(stderr, "\nThis program can handle graphs up to %d vertices. Recompile with a larger\n", MAXN);
+    fprintf(stderr, "value for MAXN if you need to handle larger graphs.\n\n");
+    fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -D, --digraph6\n");
+    fprintf(stderr, "       Reads graphs in digraph6 format instead of watercluster format.\n");
+    fprintf(stderr, "    -h, --help\n");
+    fprintf(stderr, "       Print this help and return.\n");
+}
+
+void usage(char *name) {
+    fprintf(stderr, "Usage: %s [options]\n", name);
+    fprintf(stderr, "For more information type: %s -h \n\n", name);
+}
+
+/*
+ *
+ */
+int main(int argc, char** argv) {
+
+    GRAPH graph;
+    DEGREES out;
+    DEGREES in;
+
+    boolean (*read_graph)(FILE *, GRAPH, DEGREES, DEGREES) = read_graph_from_watercluster_file;
+    unsigned int format = GRAPH_INDEX_WATERCLUSTER;
+
+    /*=========== commandline parsing ===========*/
+
+    int c;
+    char *name = argv[0];
+    static struct option long_options[] = {
+        {"digraph6", no_argument, NULL, 'D'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int option_index = 0;
+
+    while ((c = getopt_long(argc, argv, "hD", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 'D':
+                read_graph = read_graph_from_digraph6_file;
+                format = GRAPH_INDEX_DIGRAPH6;
+                break;
+            case 'h':
+                help(name);
+                return EXIT_SUCCESS;
+            case '?':
+                usage(name);
+                return EXIT_FAILURE;
+            default:
+                fprintf(stderr, "Illegal option %c.\n", c);
+                usage(name);
+                return EXIT_FAILURE;
+        }
+    }
+
+    //the header contains the size of the input, so the offsets are collected first
+    size_t capacity = 1024;
+    unsigned long long int *offsets = (unsigned long long int *) malloc(capacity * sizeof(unsigned long long int));
+
+    while (offsets != NULL && read_graph(stdin, graph, out, in)) {
+        if(graph_count == capacity){
+            capacity *= 2;
+            offsets = (unsigned long long int *) realloc(offsets, capacity * sizeof(unsigned long long int));
+            if(offsets == NULL) break;
+        }
+        offsets[graph_count++] = input_record_offset();
+    }
+    if(offsets == NULL){
+        fprintf(stderr, "Insufficient memory\n");
+        return EXIT_FAILURE;
+    }
+
+    unsigned int header[2] = {GRAPH_INDEX_VERSION, format};
+    unsigned long long int sizes[2] = {input_end_offset(), graph_count};
+    fwrite(GRAPH_INDEX_MAGIC, 1, 8, stdout);
+    fwrite(header, sizeof(unsigned int), 2, stdout);
+    fwrite(sizes, sizeof(unsigned long long int), 2, stdout);
+    fwrite(offsets, sizeof(unsigned long long int), graph_count, stdout);
+    free(offsets);
+
+    if(fflush(stdout)){
+        fprintf(stderr, "Error while writing the index -- exiting!\n");
+        return EXIT_FAILURE;
+    }
+
+    fprintf(stderr, "Indexed %llu graph%s.\n", graph_count, graph_count==1 ? "" : "s");
+
+    return (EXIT_SUCCESS);
+}
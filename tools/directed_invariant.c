@@ -4,7 +4,7 @@
  */
 
 /* This program reads directed graphs in watercluster or digraph6 format from 
- * standard in and computes a specified invariant for them.
+ * standard in and computes one or more specified invariants for them.
  * 
  * 
  * Compile with:
@@ -17,138 +17,949 @@
 #include <stdlib.h>
 #include <getopt.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/resource.h>
+#include <errno.h>
+#include <pthread.h>
 
 #include "../shared/directed_base.h"
 #include "../shared/directed_io.h"
+#include "../shared/directed_compress.h"
+#include "../shared/directed_stats.h"
+#include "../shared/directed_invariants.h"
+#include "../shared/directed_expression.h"
+
+#define MAX_INVARIANTS 8
+
+//the number of invariants that is computed for each graph
+int invariant_count = 0;
+
+//the names of the invariants
+const char *invariant_names[MAX_INVARIANTS];
+
+void *allocate(void *data, size_t size){
+    data = realloc(data, size);
+    if(data == NULL){
+        fprintf(stderr, "Insufficient memory -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    return data;
+}
 
 //========================OVERVIEW==============================
 
-typedef struct _overview_tree_element OVERVIEW_TREE_ELEMENT;
-typedef OVERVIEW_TREE_ELEMENT OVERVIEW_TREE;
+/* The overview counts the graphs for each combination of values. The values
+ * are looked up in a hash table, so the order in which they arrive does not
+ * matter, and the elements are only sorted when they are printed.
+ */
 
-struct _overview_tree_element {
-    int value;
+typedef struct _overview_element OVERVIEW_ELEMENT;
+
+struct _overview_element {
+    int values[MAX_INVARIANTS];
     unsigned long long int count; 
     
-    OVERVIEW_TREE_ELEMENT *smaller;
-    OVERVIEW_TREE_ELEMENT *greater;
+    //the graphs that are not yet written to the split file
+    unsigned char *buffer;
+    size_t length;
+    size_t capacity;
     
+    //the split file while it is open, and whether it was already created
     FILE *file;
+    boolean created;
+    OVERVIEW_ELEMENT *newer;
+    OVERVIEW_ELEMENT *older;
+    
+    //the parts of the spill file that belong to this element
+    off_t *chunk_offsets;
+    size_t *chunk_lengths;
+    int chunk_count;
+    int chunk_capacity;
 };
 
-OVERVIEW_TREE_ELEMENT *new_overview_tree_element(int value) {
-    OVERVIEW_TREE_ELEMENT *el = (OVERVIEW_TREE_ELEMENT *)malloc(sizeof(OVERVIEW_TREE_ELEMENT));
+typedef struct {
+    OVERVIEW_ELEMENT **elements;
+    int size;
+    int capacity;
     
-    el->value = value;
-    el->count = 0ULL;
-    el->smaller = NULL;
-    el->greater = NULL;
-    el->file = NULL;
+    //the positions in elements plus 1, or 0 for an empty slot
+    int *table;
+    int table_size;
+
+    OVERVIEW_ELEMENT *last;
+} OVERVIEW;
+
+OVERVIEW_ELEMENT *new_overview_element(int values[]) {
+    OVERVIEW_ELEMENT *el = (OVERVIEW_ELEMENT *)allocate(NULL, sizeof(OVERVIEW_ELEMENT));
+    
+    memset(el, 0, sizeof(OVERVIEW_ELEMENT));
+    memcpy(el->values, values, invariant_count*sizeof(int));
     
     return el;
 }
 
-void free_overview_tree(OVERVIEW_TREE *overview) {
-    if(overview->smaller != NULL) free_overview_tree(overview->smaller);
-    if(overview->greater != NULL) free_overview_tree(overview->greater);
-    if(overview->file != NULL) fclose(overview->file);
+void free_overview(OVERVIEW *overview) {
+    int i;
+    for(i = 0; i < overview->size; i++){
+        free(overview->elements[i]->buffer);
+        free(overview->elements[i]->chunk_offsets);
+        free(overview->elements[i]->chunk_lengths);
+        free(overview->elements[i]);
+    }
+    free(overview->elements);
+    free(overview->table);
+    memset(overview, 0, sizeof(OVERVIEW));
+}
+
+/**
+ * Compares the values lexicographically.
+ */
+int compare_values(int values1[], int values2[]){
+    int i;
+    for(i = 0; i < invariant_count; i++){
+        if(values1[i] != values2[i]){
+            return values1[i] < values2[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+int compare_elements(const void *a, const void *b){
+    return compare_values((*(OVERVIEW_ELEMENT **)a)->values, (*(OVERVIEW_ELEMENT **)b)->values);
+}
+
+unsigned int hash_values(int values[]){
+    unsigned int hash = 0;
+    int i;
+    for(i = 0; i < invariant_count; i++){
+        hash = (hash ^ (unsigned int)values[i]) * 0x9E3779B1U;
+    }
+    return hash ^ (hash >> 15);
+}
+
+/**
+ * Returns the position in the hash table of the values, or of the empty slot
+ * where they should be inserted.
+ */
+int find_slot(OVERVIEW *overview, int values[]){
+    int slot = hash_values(values) & (overview->table_size - 1);
+    while(overview->table[slot] &&
+            compare_values(overview->elements[overview->table[slot] - 1]->values, values)){
+        slot = (slot + 1) & (overview->table_size - 1);
+    }
+    return slot;
+}
+
+void grow_overview_table(OVERVIEW *overview){
+    int i;
+    overview->table_size = overview->table_size ? 2*overview->table_size : 1024;
+    free(overview->table);
+    overview->table = (int *)allocate(NULL, overview->table_size*sizeof(int));
+    memset(overview->table, 0, overview->table_size*sizeof(int));
+    for(i = 0; i < overview->size; i++){
+        overview->table[find_slot(overview, overview->elements[i]->values)] = i + 1;
+    }
+}
+
+OVERVIEW_ELEMENT *find_element_for_values(OVERVIEW *overview, int values[]){
+    int slot;
     
-    free(overview);
+    //consecutive graphs often have the same values
+    if(overview->last != NULL && !compare_values(overview->last->values, values)){
+        return overview->last;
+    }
+    
+    //keep the table at most half full
+    if(2*(overview->size + 1) > overview->table_size){
+        grow_overview_table(overview);
+    }
+    slot = find_slot(overview, values);
+    if(!overview->table[slot]){
+        if(overview->size == overview->capacity){
+            overview->capacity = overview->capacity ? 2*overview->capacity : 256;
+            overview->elements = (OVERVIEW_ELEMENT **)allocate(overview->elements,
+                    overview->capacity*sizeof(OVERVIEW_ELEMENT *));
+        }
+        overview->elements[overview->size++] = new_overview_element(values);
+        overview->table[slot] = overview->size;
+    }
+    return overview->last = overview->elements[overview->table[slot] - 1];
+}
+    
+/**
+ * Adds the counts of the second overview to the first one.
+ */
+void merge_overview(OVERVIEW *overview, OVERVIEW *other){
+    int i;
+    for(i = 0; i < other->size; i++){
+        find_element_for_values(overview, other->elements[i]->values)->count += other->elements[i]->count;
+    }
 }
 
-OVERVIEW_TREE_ELEMENT *find_element_for_value(OVERVIEW_TREE_ELEMENT *ote, int value){
-    if(value == ote->value){
-        return ote;
-    } else if (value < ote->value){
-        if (ote->smaller == NULL){
-            ote->smaller = new_overview_tree_element(value);
+/**
+ * Sorts the elements by their values. No elements can be added afterwards.
+ */
+void sort_overview(OVERVIEW *overview){
+    if(overview->size > 1){
+        qsort(overview->elements, overview->size, sizeof(OVERVIEW_ELEMENT *), compare_elements);
+    }
+    //the positions in the hash table are no longer valid
+    free(overview->table);
+    overview->table = NULL;
+    overview->table_size = 0;
+    overview->last = NULL;
+}
+
+void print_overview(OVERVIEW *overview, FILE *f){
+    int i, j;
+    for(j = 0; j < overview->size; j++){
+        OVERVIEW_ELEMENT *el = overview->elements[j];
+        if(invariant_count == 1){
+            fprintf(f, "%llu graph%s value %d.\n", el->count, (el->count)==1 ? " has" : "s have", el->values[0]);
+        } else {
+            fprintf(f, "%llu graph%s values (", el->count, (el->count)==1 ? " has" : "s have");
+            for(i = 0; i < invariant_count; i++){
+                fprintf(f, "%s%d", i ? ", " : "", el->values[i]);
+            }
+            fprintf(f, ").\n");
         }
-        return find_element_for_value(ote->smaller, value);
-    } else { // value > ote->value
-        if (ote->greater == NULL){
-            ote->greater = new_overview_tree_element(value);
+    }
+}
+
+//========================SPLIT==============================
+
+/* When the graphs are split by value, each element of the overview collects
+ * its graphs in a buffer. A full buffer is appended to the split file of the
+ * element. Only the most recently used split files are kept open: at most
+ * SPLIT_OPEN_FILES, and fewer if the limit on open files does not leave room
+ * for them. The others are closed and reopened for appending when needed. If
+ * a file still cannot be opened because there are too many open files, the
+ * oldest split file is closed and the file is opened again.
+ * 
+ * The graphs can also be written to a single container in which the graphs
+ * of each element are consecutive. Full buffers are then written to a spill
+ * file, and the container is assembled at the end. A table with for each
+ * element the number of its first graph, the number of graphs and the offset
+ * in the container is written to the file container.buckets. The graphs of an
+ * element can be selected with --range first:last.
+ */
+
+#define SPLIT_BUFFER_SIZE (1 << 16)
+#define SPLIT_MEMORY_LIMIT (1 << 26)
+#define SPLIT_OPEN_FILES 64
+//the descriptors that are kept free for the input, the output and the container
+#define SPLIT_RESERVED_FILES 8
+
+//the graphs with each value, in the order in which they are written
+OVERVIEW split_overview;
+
+char *split_prefix;
+char *split_extension;
+GRAPH_WRITER split_writer;
+
+unsigned char split_header[MAXHEADERLENGTH];
+size_t split_header_length;
+boolean split_header_known = FALSE;
+
+size_t split_memory = 0;
+
+int open_split_files = 0;
+int max_open_split_files = 0;
+OVERVIEW_ELEMENT *newest_split_file = NULL;
+OVERVIEW_ELEMENT *oldest_split_file = NULL;
+
+char *container_name = NULL;
+FILE *container = NULL;
+FILE *spill = NULL;
+off_t spill_length = 0;
+size_t largest_chunk = 0;
+
+void split_file_name(OVERVIEW_ELEMENT *el, char *filename, size_t size){
+    //the file name contains the values separated by underscores
+    int i;
+    int length = snprintf(filename, size, "%s", split_prefix);
+    for(i = 0; i < invariant_count && length > 0 && length < size; i++){
+        length += snprintf(filename + length, size - length, "_%d", el->values[i]);
+    }
+    if(length <= 0 || length >= size ||
+            snprintf(filename + length, size - length, ".%s%s", split_extension,
+            compression_extension()) >= size - length){
+        fprintf(stderr, "Could not create file for value %d -- exiting!\n", el->values[0]);
+        exit(EXIT_FAILURE);
+    }
+}
+
+void unlink_split_file(OVERVIEW_ELEMENT *el){
+    if(el->newer != NULL) el->newer->older = el->older; else newest_split_file = el->older;
+    if(el->older != NULL) el->older->newer = el->newer; else oldest_split_file = el->newer;
+    el->newer = el->older = NULL;
+}
+
+void close_split_file(OVERVIEW_ELEMENT *el){
+    unlink_split_file(el);
+    close_graph_output(el->file);
+    el->file = NULL;
+    open_split_files--;
+}
+
+/**
+ * Returns the number of split files that can be open at the same time.
+ */
+int split_file_limit(){
+    struct rlimit limit;
+    
+    if(max_open_split_files == 0){
+        max_open_split_files = SPLIT_OPEN_FILES;
+        if(getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY &&
+                limit.rlim_cur < SPLIT_OPEN_FILES + SPLIT_RESERVED_FILES){
+            max_open_split_files = (int)limit.rlim_cur - SPLIT_RESERVED_FILES;
+            if(max_open_split_files < 1){
+                max_open_split_files = 1;
+            }
         }
-        return find_element_for_value(ote->greater, value);
     }
+    return max_open_split_files;
 }
 
-OVERVIEW_TREE *add_to_overview(OVERVIEW_TREE *overview, int value, boolean write_graph_to_file, char *file_prefix, GRAPH graph, DEGREES out, DEGREES in){
-    //find correct element
-    OVERVIEW_TREE_ELEMENT *ote;
-    if(overview==NULL){
-        overview = ote = new_overview_tree_element(value);
+/**
+ * Returns the split file of the element, and opens it if necessary.
+ */
+FILE *split_file(OVERVIEW_ELEMENT *el){
+    if(el->file != NULL){
+        unlink_split_file(el);
     } else {
-        ote = find_element_for_value(overview, value);
+        char filename[200];
+        if(open_split_files >= split_file_limit()){
+            close_split_file(oldest_split_file);
+        }
+        split_file_name(el, filename, sizeof(filename));
+        el->file = fopen(filename, el->created ? "a" : "w");
+        while(el->file == NULL && (errno == EMFILE || errno == ENFILE) && open_split_files > 0){
+            //other files use more descriptors than expected
+            close_split_file(oldest_split_file);
+            max_open_split_files = open_split_files + 1;
+            el->file = fopen(filename, el->created ? "a" : "w");
+        }
+        if (el->file==NULL) {
+            fprintf(stderr, "Could not create file for value %d -- exiting!\n", el->values[0]);
+            exit(EXIT_FAILURE);
+        }
+        if(!el->created && split_header_length){
+            write_graph_code(split_header, split_header_length, el->file);
+        }
+        el->created = TRUE;
+        open_split_files++;
     }
     
-    //add graph
-    ote->count++;
+    //the element becomes the most recently used
+    el->older = newest_split_file;
+    if(newest_split_file != NULL) newest_split_file->newer = el; else oldest_split_file = el;
+    newest_split_file = el;
     
-    if(write_graph_to_file){
-        if(ote->file==NULL){
-            char filename[100];
-            if(sprintf(filename, "%s_%d.wcf", file_prefix, value)>0){
-                ote->file = fopen(filename, "w");
-            } else {
-                fprintf(stderr, "Could not create file for value %d -- exiting!\n", value);
-                exit(EXIT_FAILURE);
-            }
-            if (ote->file==NULL) {
-                fprintf(stderr, "Could not create file for value %d -- exiting!\n", value);
+    return el->file;
+}
+
+void spill_split_data(OVERVIEW_ELEMENT *el, const unsigned char *data, size_t length){
+    if(el->chunk_count &&
+            el->chunk_offsets[el->chunk_count - 1] + el->chunk_lengths[el->chunk_count - 1] == spill_length &&
+            el->chunk_lengths[el->chunk_count - 1] + length <= OUTPUT_BLOCK_SIZE){
+        //the previous chunk of this element is at the end of the spill file, and
+        //the chunks stay small enough to be written without splitting a graph
+        el->chunk_lengths[el->chunk_count - 1] += length;
+    } else {
+        if(el->chunk_count == el->chunk_capacity){
+            el->chunk_capacity = el->chunk_capacity ? 2*el->chunk_capacity : 4;
+            el->chunk_offsets = (off_t *)allocate(el->chunk_offsets, el->chunk_capacity*sizeof(off_t));
+            el->chunk_lengths = (size_t *)allocate(el->chunk_lengths, el->chunk_capacity*sizeof(size_t));
+        }
+        el->chunk_offsets[el->chunk_count] = spill_length;
+        el->chunk_lengths[el->chunk_count] = length;
+        el->chunk_count++;
+    }
+    if(el->chunk_lengths[el->chunk_count - 1] > largest_chunk){
+        largest_chunk = el->chunk_lengths[el->chunk_count - 1];
+    }
+    write_fully(fileno(spill), data, length);
+    spill_length += length;
+}
+
+void write_split_data(OVERVIEW_ELEMENT *el, const unsigned char *data, size_t length){
+    if(container != NULL){
+        spill_split_data(el, data, length);
+    } else {
+        write_graph_code((unsigned char *)data, length, split_file(el));
+    }
+}
+
+void flush_split_buffer(OVERVIEW_ELEMENT *el){
+    if(el->length == 0) return;
+    write_split_data(el, el->buffer, el->length);
+    split_memory -= el->length;
+    el->length = 0;
+}
+
+/**
+ * Writes all buffers and releases their memory.
+ */
+void flush_split_buffers(){
+    int i;
+    for(i = 0; i < split_overview.size; i++){
+        OVERVIEW_ELEMENT *el = split_overview.elements[i];
+        flush_split_buffer(el);
+        free(el->buffer);
+        el->buffer = NULL;
+        el->capacity = 0;
+    }
+}
+
+void start_split(char *prefix, char *extension, GRAPH_WRITER writer){
+    split_prefix = prefix;
+    split_extension = extension;
+    split_writer = writer;
+    if(container_name != NULL){
+        container = fopen(container_name, "w");
+        spill = tmpfile();
+        if(container == NULL || spill == NULL){
+            fprintf(stderr, "Could not create container %s -- exiting!\n", container_name);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+/**
+ * Adds the graph with the given code to the split of its values.
+ */
+void split_graph(int values[], const unsigned char *code, size_t length){
+    OVERVIEW_ELEMENT *el = find_element_for_values(&split_overview, values);
+    
+    el->count++;
+    if(!split_header_known){
+        //the header of raw input is only known after the first graph
+        split_header_length = encode_graph_header(split_writer, split_header);
+        split_header_known = TRUE;
+    }
+    
+    if(el->length + length > SPLIT_BUFFER_SIZE){
+        flush_split_buffer(el);
+        if(length > SPLIT_BUFFER_SIZE){
+            //too large to buffer
+            write_split_data(el, code, length);
+            return;
+        }
+    }
+    if(el->length + length > el->capacity){
+        while(el->length + length > el->capacity){
+            el->capacity = el->capacity ? 2*el->capacity : 1024;
+        }
+        el->buffer = (unsigned char *)allocate(el->buffer, el->capacity);
+    }
+    memcpy(el->buffer + el->length, code, length);
+    el->length += length;
+    split_memory += length;
+    if(split_memory > SPLIT_MEMORY_LIMIT){
+        flush_split_buffers();
+    }
+}
+
+/**
+ * Copies the graphs of each element from the spill file to the container in
+ * the order of the values, and writes the table with the offsets.
+ */
+void write_container(){
+    char filename[200];
+    FILE *table;
+    int i, j;
+    unsigned long long int first = 1;
+    unsigned char *chunk = (unsigned char *)allocate(NULL, largest_chunk ? largest_chunk : 1);
+    
+    if(snprintf(filename, sizeof(filename), "%s.buckets", container_name) >= sizeof(filename) ||
+            (table = fopen(filename, "w")) == NULL){
+        fprintf(stderr, "Could not create file %s.buckets -- exiting!\n", container_name);
+        exit(EXIT_FAILURE);
+    }
+    fprintf(table, "# values\tfirst\tcount\toffset\n");
+    
+    if(split_header_length){
+        write_graph_code(split_header, split_header_length, container);
+    }
+    for(i = 0; i < split_overview.size; i++){
+        OVERVIEW_ELEMENT *el = split_overview.elements[i];
+        
+        //each element starts at a block boundary, also in compressed output
+        flush_graph_output(container);
+        off_t offset = lseek(fileno(container), 0, SEEK_CUR);
+        
+        for(j = 0; j < el->chunk_count; j++){
+            if(pread(fileno(spill), chunk, el->chunk_lengths[j], el->chunk_offsets[j]) != el->chunk_lengths[j]){
+                fprintf(stderr, "Could not read spill file -- exiting!\n");
                 exit(EXIT_FAILURE);
             }
+            write_graph_code(chunk, el->chunk_lengths[j], container);
+        }
+        
+        for(j = 0; j < invariant_count; j++){
+            fprintf(table, "%s%d", j ? "," : "", el->values[j]);
         }
-        write_watercluster_format(graph, out, ote->file);
+        fprintf(table, "\t%llu\t%llu\t%lld\n", first, el->count, (long long int)offset);
+        first += el->count;
     }
-    return overview;
+    
+    free(chunk);
+    fclose(table);
+    close_graph_output(container);
+    fclose(spill);
 }
 
-void print_overview(OVERVIEW_TREE *overview, FILE *f){
-    if(overview->smaller!=NULL) print_overview(overview->smaller, f);
-    fprintf(f, "%llu graph%s value %d.\n", overview->count, (overview->count)==1 ? " has" : "s have", overview->value);
-    if(overview->greater!=NULL) print_overview(overview->greater, f);
+/**
+ * Writes the remaining buffers and closes all split files.
+ */
+void finish_split(){
+    flush_split_buffers();
+    sort_overview(&split_overview);
+    while(newest_split_file != NULL){
+        close_split_file(newest_split_file);
+    }
+    if(container != NULL){
+        write_container();
+    }
+    free_overview(&split_overview);
+}
+
+//========================SUMMARY==============================
+
+/* A summary holds the minimum and maximum of each invariant, with the number
+ * of graphs that attain them and the first of these graphs, and optionally the
+ * overview of all values. Each thread keeps its own summary, and these are
+ * merged at the end. Ties are resolved by the graph number, so the result does
+ * not depend on which thread handled which graph.
+ * 
+ * Summaries can be saved to a file and merged with --merge. This combines
+ * runs on parts of the same input (e.g. selected with --range), which keep
+ * the graph numbers of the complete input.
+ */
+
+#define SUMMARY_HEADER "# directed_invariant summary"
+
+typedef struct {
+    unsigned long long int read_count;
+    unsigned long long int selected_count;
+    
+    int min[MAX_INVARIANTS];
+    int max[MAX_INVARIANTS];
+    unsigned long long int min_count[MAX_INVARIANTS];
+    unsigned long long int max_count[MAX_INVARIANTS];
+    unsigned long long int min_graph[MAX_INVARIANTS];
+    unsigned long long int max_graph[MAX_INVARIANTS];
+    
+    //whether the overview of all values is kept
+    boolean keep_overview;
+    OVERVIEW overview;
+} SUMMARY;
+
+void add_to_summary(SUMMARY *summary, int values[], unsigned long long int graph){
+    int i;
+    for(i = 0; i < invariant_count; i++){
+        if(!summary->selected_count || summary->min[i] > values[i]){
+            summary->min[i] = values[i];
+            summary->min_count[i] = 1;
+            summary->min_graph[i] = graph;
+        } else if(summary->min[i] == values[i]){
+            summary->min_count[i]++;
+            if(graph < summary->min_graph[i]) summary->min_graph[i] = graph;
+        }
+        if(!summary->selected_count || summary->max[i] < values[i]){
+            summary->max[i] = values[i];
+            summary->max_count[i] = 1;
+            summary->max_graph[i] = graph;
+        } else if(summary->max[i] == values[i]){
+            summary->max_count[i]++;
+            if(graph < summary->max_graph[i]) summary->max_graph[i] = graph;
+        }
+    }
+    summary->selected_count++;
+    if(summary->keep_overview){
+        find_element_for_values(&(summary->overview), values)->count++;
+    }
 }
 
-//========================INVARIANTS==============================
+/**
+ * Adds the graphs of the second summary to the first one.
+ */
+void merge_summary(SUMMARY *summary, SUMMARY *other){
+    int i;
+    summary->read_count += other->read_count;
+    if(!other->selected_count){
+        return;
+    }
+    for(i = 0; i < invariant_count; i++){
+        if(!summary->selected_count || other->min[i] < summary->min[i]){
+            summary->min[i] = other->min[i];
+            summary->min_count[i] = other->min_count[i];
+            summary->min_graph[i] = other->min_graph[i];
+        } else if(other->min[i] == summary->min[i]){
+            summary->min_count[i] += other->min_count[i];
+            if(other->min_graph[i] < summary->min_graph[i]) summary->min_graph[i] = other->min_graph[i];
+        }
+        if(!summary->selected_count || other->max[i] > summary->max[i]){
+            summary->max[i] = other->max[i];
+            summary->max_count[i] = other->max_count[i];
+            summary->max_graph[i] = other->max_graph[i];
+        } else if(other->max[i] == summary->max[i]){
+            summary->max_count[i] += other->max_count[i];
+            if(other->max_graph[i] < summary->max_graph[i]) summary->max_graph[i] = other->max_graph[i];
+        }
+    }
+    summary->selected_count += other->selected_count;
+    if(summary->keep_overview){
+        merge_overview(&(summary->overview), &(other->overview));
+    }
+}
 
-int arc_count(GRAPH graph, DEGREES out, DEGREES in){
+void print_summary(SUMMARY *summary, FILE *f){
     int i;
-    int count = 0;
-    for(i=1; i<=graph[0][0]; i++){
-        count+=out[i];
+    for(i = 0; i < invariant_count; i++){
+        if(invariant_count > 1){
+            fprintf(f, "Invariant %s\n", invariant_names[i]);
+        }
+        fprintf(f, "Minimum: %d\nMaximum: %d\n", summary->min[i], summary->max[i]);
+        fprintf(f, "%llu graph%s the minimum and %s is graph %llu.\n",
+                summary->min_count[i], summary->min_count[i]==1 ? " has" : "s have",
+                summary->min_count[i]==1 ? "this" : "the first of these",
+                summary->min_graph[i]);
+        fprintf(f, "%llu graph%s the maximum and %s is graph %llu.\n",
+                summary->max_count[i], summary->max_count[i]==1 ? " has" : "s have",
+                summary->max_count[i]==1 ? "this" : "the first of these",
+                summary->max_graph[i]);
+    }
+}
+
+/**
+ * Writes the summary as text. The overview should be sorted.
+ */
+void save_summary(SUMMARY *summary, const char *expression_text, const char *filename){
+    int i, j;
+    FILE *f = fopen(filename, "w");
+    if(f == NULL){
+        fprintf(stderr, "Could not create %s -- exiting!\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    fprintf(f, "%s\ninvariants", SUMMARY_HEADER);
+    for(i = 0; i < invariant_count; i++){
+        fprintf(f, "\t%s", invariant_names[i]);
+    }
+    fprintf(f, "\n");
+    if(expression_text != NULL){
+        fprintf(f, "expression\t%s\n", expression_text);
+    }
+    fprintf(f, "read\t%llu\nselected\t%llu\n", summary->read_count, summary->selected_count);
+    for(i = 0; summary->selected_count && i < invariant_count; i++){
+        fprintf(f, "minimum\t%d\t%llu\t%llu\n", summary->min[i], summary->min_count[i], summary->min_graph[i]);
+        fprintf(f, "maximum\t%d\t%llu\t%llu\n", summary->max[i], summary->max_count[i], summary->max_graph[i]);
+    }
+    for(j = 0; j < summary->overview.size; j++){
+        OVERVIEW_ELEMENT *el = summary->overview.elements[j];
+        fprintf(f, "values\t%llu", el->count);
+        for(i = 0; i < invariant_count; i++){
+            fprintf(f, "\t%d", el->values[i]);
+        }
+        fprintf(f, "\n");
+    }
+    fclose(f);
+}
+
+void illegal_summary(const char *filename, int line){
+    fprintf(stderr, "Illegal summary in %s at line %d -- exiting!\n", filename, line);
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * Reads a summary that was written by save_summary(). The first summary sets
+ * the invariants and the expression, and the next ones should have the same.
+ */
+void load_summary(SUMMARY *summary, char **expression_text, const char *filename){
+    static boolean first = TRUE;
+    char line[1024];
+    char *field;
+    int i, line_number = 0;
+    int minimum = 0, maximum = 0;
+    FILE *f = fopen(filename, "r");
+    
+    if(f == NULL){
+        fprintf(stderr, "Could not open %s -- exiting!\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    while(fgets(line, sizeof(line), f) != NULL){
+        line_number++;
+        line[strcspn(line, "\n")] = '\0';
+        if(line_number == 1){
+            if(strcmp(line, SUMMARY_HEADER)) illegal_summary(filename, line_number);
+            continue;
+        }
+        field = strtok(line, "\t");
+        if(field == NULL){
+            illegal_summary(filename, line_number);
+        } else if(!strcmp(field, "invariants")){
+            for(i = 0; (field = strtok(NULL, "\t")) != NULL; i++){
+                if(i == MAX_INVARIANTS) illegal_summary(filename, line_number);
+                if(first){
+                    invariant_names[i] = strdup(field);
+                } else if(i >= invariant_count || strcmp(invariant_names[i], field)){
+                    fprintf(stderr, "The summary in %s has other invariants -- exiting!\n", filename);
+                    exit(EXIT_FAILURE);
+                }
+            }
+            if(first){
+                invariant_count = i;
+            } else if(i != invariant_count){
+                fprintf(stderr, "The summary in %s has other invariants -- exiting!\n", filename);
+                exit(EXIT_FAILURE);
+            }
+        } else if(!strcmp(field, "expression")){
+            field = strtok(NULL, "");
+            if(first){
+                *expression_text = strdup(field == NULL ? "" : field);
+            } else if(*expression_text == NULL || strcmp(*expression_text, field == NULL ? "" : field)){
+                fprintf(stderr, "The summary in %s has another expression -- exiting!\n", filename);
+                exit(EXIT_FAILURE);
+            }
+        } else if(!strcmp(field, "read") && (field = strtok(NULL, "\t")) != NULL){
+            summary->read_count = strtoull(field, NULL, 10);
+        } else if(!strcmp(field, "selected") && (field = strtok(NULL, "\t")) != NULL){
+            summary->selected_count = strtoull(field, NULL, 10);
+        } else if(!strcmp(field, "minimum") || !strcmp(field, "maximum")){
+            boolean is_minimum = !strcmp(field, "minimum");
+            int value;
+            unsigned long long int count, graph;
+            i = is_minimum ? minimum++ : maximum++;
+            if(i >= invariant_count ||
+                    sscanf(line + strlen(field) + 1, "%d\t%llu\t%llu", &value, &count, &graph) != 3){
+                illegal_summary(filename, line_number);
+            }
+            if(is_minimum){
+                summary->min[i] = value;
+                summary->min_count[i] = count;
+                summary->min_graph[i] = graph;
+            } else {
+                summary->max[i] = value;
+                summary->max_count[i] = count;
+                summary->max_graph[i] = graph;
+            }
+        } else if(!strcmp(field, "values") && (field = strtok(NULL, "\t")) != NULL){
+            int values[MAX_INVARIANTS];
+            unsigned long long int count = strtoull(field, NULL, 10);
+            for(i = 0; i < invariant_count; i++){
+                if((field = strtok(NULL, "\t")) == NULL) illegal_summary(filename, line_number);
+                values[i] = atoi(field);
+            }
+            find_element_for_values(&(summary->overview), values)->count += count;
+        } else {
+            illegal_summary(filename, line_number);
+        }
+    }
+    if(line_number == 0 || (summary->selected_count && (minimum != invariant_count || maximum != invariant_count))){
+        illegal_summary(filename, line_number);
+    }
+    fclose(f);
+    first = FALSE;
+}
+
+//========================THREADS==============================
+
+/* The graphs are read in batches by the main thread. The invariants of the
+ * graphs in a batch are computed by all threads together, each with its own
+ * expression (the values of its terms are cached per graph) and its own
+ * summary. The main thread then writes the selected graphs of the batch in
+ * the order of the input.
+ */
+
+#define BATCH_SIZE 1024
+#define WORK_CHUNK 16
+
+typedef struct {
+    GRAPH graph;
+    DEGREES out;
+    DEGREES in;
+    
+    unsigned long long int number;
+    boolean selected;
+    int values[MAX_INVARIANTS];
+    
+    //the position of the encoded graph in the code of the batch
+    size_t code_start;
+    size_t code_length;
+} BATCH_ENTRY;
+
+typedef struct {
+    EXPRESSION *expression;
+    int terms[MAX_INVARIANTS];
+    SUMMARY summary;
+    pthread_t thread;
+} WORKER;
+
+BATCH_ENTRY batch[BATCH_SIZE];
+int batch_size = 0;
+
+//the encoded graphs of the batch that are needed for the output
+unsigned char *batch_code = NULL;
+size_t batch_code_length = 0;
+size_t batch_code_capacity = 0;
+
+WORKER *workers = NULL;
+int worker_count = 1;
+
+pthread_mutex_t batch_mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t batch_ready = PTHREAD_COND_INITIALIZER;
+pthread_cond_t batch_done = PTHREAD_COND_INITIALIZER;
+int batch_generation = 0;
+int busy_workers = 0;
+int next_entry = 0;
+
+void store_batch_code(BATCH_ENTRY *entry, GRAPH_WRITER writer){
+    const unsigned char *code = encode_graph(writer, entry->graph, entry->out, &(entry->code_length));
+    
+    if(batch_code_length + entry->code_length > batch_code_capacity){
+        while(batch_code_length + entry->code_length > batch_code_capacity){
+            batch_code_capacity = batch_code_capacity ? 2*batch_code_capacity : (1 << 16);
+        }
+        batch_code = (unsigned char *)allocate(batch_code, batch_code_capacity);
     }
-    return count;
+    memcpy(batch_code + batch_code_length, code, entry->code_length);
+    entry->code_start = batch_code_length;
+    batch_code_length += entry->code_length;
 }
 
-int sink_count(GRAPH graph, DEGREES out, DEGREES in){
+void process_entry(WORKER *worker, BATCH_ENTRY *entry){
     int i;
-    int count = 0;
-    for(i=1; i<=graph[0][0]; i++){
-        if(out[i]==0) count++;
+    clear_expression_values(worker->expression);
+    entry->selected = evaluate_expression(worker->expression, entry->graph, entry->out, entry->in);
+    if(entry->selected){
+        for(i = 0; i < invariant_count; i++){
+            entry->values[i] = expression_term_value(worker->expression, worker->terms[i],
+                    entry->graph, entry->out, entry->in);
+        }
+        add_to_summary(&(worker->summary), entry->values, entry->number);
+    }
+}
+
+void process_entries(WORKER *worker){
+    int first, i;
+    while((first = __sync_fetch_and_add(&next_entry, WORK_CHUNK)) < batch_size){
+        for(i = first; i < first + WORK_CHUNK && i < batch_size; i++){
+            process_entry(worker, batch + i);
+        }
     }
-    return count;
 }
 
-int source_count(GRAPH graph, DEGREES out, DEGREES in){
+void *worker_thread(void *argument){
+    WORKER *worker = (WORKER *) argument;
+    int generation = 0;
+    
+    while(TRUE){
+        pthread_mutex_lock(&batch_mutex);
+        while(batch_generation == generation){
+            pthread_cond_wait(&batch_ready, &batch_mutex);
+        }
+        generation = batch_generation;
+        pthread_mutex_unlock(&batch_mutex);
+        
+        //an empty batch means that the input is finished
+        if(batch_size == 0){
+            merge_thread_search_nodes();
+            return NULL;
+        }
+        process_entries(worker);
+        
+        pthread_mutex_lock(&batch_mutex);
+        if(--busy_workers == 0){
+            pthread_cond_signal(&batch_done);
+        }
+        pthread_mutex_unlock(&batch_mutex);
+    }
+}
+
+/**
+ * Computes the invariants for all graphs in the batch. The main thread is the
+ * first worker.
+ */
+void process_batch(){
+    next_entry = 0;
+    if(worker_count == 1){
+        process_entries(workers);
+        return;
+    }
+    pthread_mutex_lock(&batch_mutex);
+    busy_workers = worker_count - 1;
+    batch_generation++;
+    pthread_cond_broadcast(&batch_ready);
+    pthread_mutex_unlock(&batch_mutex);
+    
+    process_entries(workers);
+    
+    pthread_mutex_lock(&batch_mutex);
+    while(busy_workers){
+        pthread_cond_wait(&batch_done, &batch_mutex);
+    }
+    pthread_mutex_unlock(&batch_mutex);
+}
+
+void start_workers(char *expression_text, const INVARIANT *selected[], boolean keep_overview){
+    int i, j;
+    workers = (WORKER *)allocate(NULL, worker_count*sizeof(WORKER));
+    memset(workers, 0, worker_count*sizeof(WORKER));
+    for(i = 0; i < worker_count; i++){
+        workers[i].expression = expression_text == NULL ? new_expression() : parse_expression(expression_text);
+        //the invariants share the values that are computed for the expression
+        for(j = 0; j < invariant_count; j++){
+            workers[i].terms[j] = expression_term(workers[i].expression, selected[j]);
+        }
+        workers[i].summary.keep_overview = keep_overview;
+        if(i && pthread_create(&(workers[i].thread), NULL, worker_thread, workers + i)){
+            fprintf(stderr, "Could not create thread -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+/**
+ * Stops the threads and merges their summaries into the summary of the main
+ * thread.
+ */
+void stop_workers(){
     int i;
-    int count = 0;
-    for(i=1; i<=graph[0][0]; i++){
-        if(in[i]==0) count++;
+    pthread_mutex_lock(&batch_mutex);
+    batch_size = 0;
+    batch_generation++;
+    pthread_cond_broadcast(&batch_ready);
+    pthread_mutex_unlock(&batch_mutex);
+    for(i = 1; i < worker_count; i++){
+        pthread_join(workers[i].thread, NULL);
+        merge_summary(&(workers[0].summary), &(workers[i].summary));
+        free_overview(&(workers[i].summary.overview));
+        free_expression(workers[i].expression);
     }
-    return count;
 }
 
 //====================== USAGE =======================
 
 void help(char *name) {
-    fprintf(stderr, "Computes an invariant for the directed graphs read from standard in.\n\n");
+    fprintf(stderr, "Computes invariants for the directed graphs read from standard in.\n\n");
     fprintf(stderr, "Usage\n=====\n");
-    fprintf(stderr, " %s invariant [options]\n\n", name);
+    fprintf(stderr, " %s invariant... [options]\n", name);
+    fprintf(stderr, " %s --merge [options] summary...\n\n", name);
+    fprintf(stderr, "When several invariants are given, the summary and the split are made by\n");
+    fprintf(stderr, "the combination of their values.\n");
     fprintf(stderr, "\nThis program can handle graphs up to %d vertices. Recompile with a larger\n", MAXN);
     fprintf(stderr, "value for MAXN if you need to handle larger graphs.\n\n");
     fprintf(stderr, "Valid options\n=============\n");
     fprintf(stderr, "    -i, --invariants\n");
     fprintf(stderr, "       Print a list of available invariants and return.\n");
+    fprintf(stderr, "    -e expression, --expression expression\n");
+    fprintf(stderr, "       Only take into account the graphs for which the expression is true,\n");
+    fprintf(stderr, "       and write these graphs to standard out. An expression combines\n");
+    fprintf(stderr, "       invariants with ==, !=, <, <=, >, >=, !, && and ||, e.g.\n");
+    fprintf(stderr, "       'hypoham && !z6 && arcs>=40'. Cheap invariants are evaluated first and\n");
+    fprintf(stderr, "       only as far as needed. The invariants can be omitted with this option.\n");
     fprintf(stderr, "    -f #, --filter #\n");
     fprintf(stderr, "       Filter graphs that have the specified value for the invariant.\n");
     fprintf(stderr, "    -l, --less\n");
@@ -160,24 +971,45 @@ void help(char *name) {
     fprintf(stderr, "    -s, --summary\n");
     fprintf(stderr, "       Print an overview of the distribution of all values.\n");
     fprintf(stderr, "    -S prefix, --split prefix\n");
-    fprintf(stderr, "       If a graph has value #, then it is written to the file prefix_#.wcf.\n");
+    fprintf(stderr, "       If a graph has value #, then it is written to the file prefix_#.wcf\n");
+    fprintf(stderr, "       (or prefix_#.d6 when the graphs are written in digraph6 format). With\n");
+    fprintf(stderr, "       several invariants the file is prefix_#_#.wcf.\n");
+    fprintf(stderr, "    -C file, --container file\n");
+    fprintf(stderr, "       Split the graphs by value into a single file in which the graphs with\n");
+    fprintf(stderr, "       the same value are consecutive. The file file.buckets lists for each\n");
+    fprintf(stderr, "       value the number of the first graph, the number of graphs and the\n");
+    fprintf(stderr, "       offset in the file.\n");
+    fprintf(stderr, "    -T n, --threads n\n");
+    fprintf(stderr, "       Compute the invariants with n threads (0 for one per processor). The\n");
+    fprintf(stderr, "       graphs are still written in the order in which they are read.\n");
+    fprintf(stderr, "    --save-summary file\n");
+    fprintf(stderr, "       Write the minimum, the maximum and the distribution of the values to\n");
+    fprintf(stderr, "       the given file.\n");
+    fprintf(stderr, "    --merge\n");
+    fprintf(stderr, "       Instead of reading graphs, merge the summaries in the files given as\n");
+    fprintf(stderr, "       arguments, e.g. of runs on parts of the input selected with --range.\n");
+    fprintf(stderr, "       This can be combined with -s and --save-summary.\n");
     fprintf(stderr, "    -D, --digraph6\n");
     fprintf(stderr, "       Reads graphs in digraph6 format instead of watercluster format.\n");
+    fprintf(stderr, "    -O format, --output-format format\n");
+    fprintf(stderr, "       Writes graphs in the given format: wcf (watercluster), d6 (digraph6),\n");
+    fprintf(stderr, "       bits (bitset container), adj (adjacency lists) or multi (multi_code).\n");
+    fprintf(stderr, "       By default, or with input, the graphs are copied unchanged from the\n");
+    fprintf(stderr, "       input.\n");
+    help_shared_io_options(stderr);
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
 
 void usage(char *name) {
-    fprintf(stderr, "\033[31mUsage: %s invariant [options]\n", name);
+    fprintf(stderr, "\033[31mUsage: %s invariant... [options]\n", name);
     fprintf(stderr, "For more information type: %s -h\n", name);
     fprintf(stderr, "For a list of invariants type: %s -i\033[0m\n\n", name);
 }
 
 void invariants() {
     fprintf(stderr, "Available invariants are\n");
-    fprintf(stderr, " * \033[1marcs\033[0m: the number of arcs in the graph\n");
-    fprintf(stderr, " * \033[1msink\033[0m: the number of sinks in the graph\n");
-    fprintf(stderr, " * \033[1msource\033[0m: the number of sources in the graph\n");
+    list_invariants(stderr);
 }
 
 /*
@@ -187,7 +1019,7 @@ int main(int argc, char** argv) {
     
     boolean filter = FALSE;
     int filter_value = -1;
-    int filtered_count = 0;
+    unsigned long long int filtered_count = 0;
     
     boolean allow_equal = TRUE;
     boolean allow_less = FALSE;
@@ -195,41 +1027,64 @@ int main(int argc, char** argv) {
     
     boolean give_overview = FALSE;
     boolean split_to_files = FALSE;
-    char *prefix;
+    char *prefix = NULL;
 
-    int graph_count = 0;
-    
-    GRAPH graph;
-    DEGREES out;
-    DEGREES in;
-    
-    OVERVIEW_TREE *overview = NULL;
+    unsigned long long int graph_count = 0;
     
     boolean verbose = FALSE;
     
     boolean (*read_graph)(FILE *, GRAPH, DEGREES, DEGREES) = read_graph_from_watercluster_file;
-    int (*invariant)(GRAPH, DEGREES, DEGREES) = NULL;
+    void (*write_graph)(GRAPH, DEGREES, FILE *) = write_input_graph;
+
+    char *expression_text = NULL;
+    const INVARIANT *selected[MAX_INVARIANTS];
+    
+    boolean merge = FALSE;
+    char *summary_file = NULL;
+    SUMMARY *summary;
 
     /*=========== commandline parsing ===========*/
 
     int c;
     char *name = argv[0];
     static struct option long_options[] = {
+        {"merge", no_argument, NULL, 0},
+        {"save-summary", required_argument, NULL, 0},
         {"not-equal", no_argument, NULL, 'n'},
         {"less", no_argument, NULL, 'l'},
         {"greater", no_argument, NULL, 'g'},
         {"filter", required_argument, NULL, 'f'},
+        {"expression", required_argument, NULL, 'e'},
         {"verbose", no_argument, NULL, 'v'},
         {"digraph6", no_argument, NULL, 'D'},
+        {"output-format", required_argument, NULL, 'O'},
         {"summary", no_argument, NULL, 's'},
         {"split", required_argument, NULL, 'S'},
+        {"container", required_argument, NULL, 'C'},
+        {"threads", required_argument, NULL, 'T'},
         {"invariants", no_argument, NULL, 'i'},
-        {"help", no_argument, NULL, 'h'}
+        {"help", no_argument, NULL, 'h'},
+        SHARED_IO_OPTIONS,
+        {NULL, 0, NULL, 0}
     };
     int option_index = 0;
 
-    while ((c = getopt_long(argc, argv, "hiDf:vS:snlg", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "hiDf:e:vS:C:T:snlgO:", long_options, &option_index)) != -1) {
         switch (c) {
+            case 0:
+                switch(option_index) {
+                    case 0:
+                        merge = TRUE;
+                        break;
+                    case 1:
+                        summary_file = optarg;
+                        break;
+                    default:
+                        fprintf(stderr, "Illegal option index %d.\n", option_index);
+                        usage(name);
+                        return EXIT_FAILURE;
+                }
+                break;
             case 'n':
                 allow_equal = FALSE;
                 break;
@@ -243,22 +1098,51 @@ int main(int argc, char** argv) {
                 filter = TRUE;
                 filter_value = atoi(optarg);
                 break;
+            case 'e':
+                expression_text = optarg;
+                break;
             case 'v':
                 verbose = TRUE;
                 break;
             case 'D':
                 read_graph = read_graph_from_digraph6_file;
                 break;
+            case 'O':
+                write_graph = input_writer_for_format(optarg);
+                if(write_graph == NULL){
+                    fprintf(stderr, "Unknown output format: %s -- exiting!\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
             case 'S':
                 split_to_files = TRUE;
                 prefix = optarg;
                 break;
+            case 'C':
+                split_to_files = TRUE;
+                container_name = optarg;
+                break;
+            case 'T':
+                worker_count = atoi(optarg);
+                if(worker_count <= 0){
+                    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+                    worker_count = processors > 1 ? (int) processors : 1;
+                }
+                break;
             case 's':
                 give_overview = TRUE;
                 break;
             case 'i':
                 invariants();
                 return EXIT_SUCCESS;
+            case SELECT_RANGE_OPTION:
+            case SELECT_IDS_OPTION:
+            case SELECT_INDEX_OPTION:
+            case COMPRESS_OPTION:
+            case COMPRESS_THREADS_OPTION:
+                handle_shared_io_option(c, optarg);
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -272,22 +1156,93 @@ int main(int argc, char** argv) {
         }
     }
     
-    if(argc - optind < 1){
+    if(merge){
+        SUMMARY part;
+        if(argc - optind < 1){
+            fprintf(stderr, "Please specify the summaries -- exiting!\n");
+            usage(name);
+            return EXIT_FAILURE;
+        }
+        if(filter || split_to_files || expression_text != NULL){
+            fprintf(stderr, "Summaries can only be merged, printed and saved -- exiting!\n");
+            usage(name);
+            return EXIT_FAILURE;
+        }
+        summary = (SUMMARY *)allocate(NULL, sizeof(SUMMARY));
+        memset(summary, 0, sizeof(SUMMARY));
+        summary->keep_overview = TRUE;
+        for(; optind < argc; optind++){
+            memset(&part, 0, sizeof(SUMMARY));
+            part.keep_overview = TRUE;
+            load_summary(&part, &expression_text, argv[optind]);
+            merge_summary(summary, &part);
+            free_overview(&(part.overview));
+        }
+        sort_overview(&(summary->overview));
+        
+        fprintf(stderr, "Read %llu graph%s.\n", summary->read_count, summary->read_count==1 ? "" : "s");
+        if(expression_text != NULL){
+            fprintf(stderr, "Selected %llu graph%s for which %s\n", summary->selected_count,
+                    summary->selected_count==1 ? "" : "s", expression_text);
+        }
+        if(summary->selected_count){
+            print_summary(summary, stderr);
+            if(give_overview) {
+                print_overview(&(summary->overview), stderr);
+            }
+        }
+        if(summary_file != NULL){
+            save_summary(summary, expression_text, summary_file);
+        }
+        free_overview(&(summary->overview));
+        free(summary);
+        return (EXIT_SUCCESS);
+    }
+    
+    if(argc - optind < 1 && expression_text == NULL){
         fprintf(stderr, "Please specifiy the invariant -- exiting!\n");
         usage(name);
         return EXIT_FAILURE;
     }
     
-    if(strcmp(argv[optind], "arcs")==0){
-        invariant = arc_count;
-    } else if(strcmp(argv[optind], "sink")==0){
-        invariant = sink_count;
-    } else if(strcmp(argv[optind], "source")==0){
-        invariant = source_count;
-    } else {
-        fprintf(stderr, "Unknown invariant -- exiting!\n");
+    if(argc - optind > MAX_INVARIANTS){
+        fprintf(stderr, "At most %d invariants can be computed at once -- exiting!\n", MAX_INVARIANTS);
         usage(name);
-        exit(EXIT_FAILURE);
+        return EXIT_FAILURE;
+    }
+
+    for(invariant_count = 0; optind + invariant_count < argc; invariant_count++){
+        selected[invariant_count] = find_invariant(argv[optind + invariant_count]);
+        if(selected[invariant_count] == NULL){
+            fprintf(stderr, "Unknown invariant -- exiting!\n");
+            usage(name);
+            exit(EXIT_FAILURE);
+        }
+        invariant_names[invariant_count] = selected[invariant_count]->name;
+    }
+
+    if(invariant_count == 0 && (filter || give_overview || split_to_files || summary_file != NULL)){
+        fprintf(stderr, "Please specifiy the invariant -- exiting!\n");
+        usage(name);
+        return EXIT_FAILURE;
+    }
+
+    if(filter && invariant_count > 1){
+        fprintf(stderr, "This filter can only be used with one invariant, use -e instead -- exiting!\n");
+        usage(name);
+        return EXIT_FAILURE;
+    }
+
+    if(filter && expression_text != NULL){
+        fprintf(stderr, "This filter cannot be combined with an expression -- exiting!\n");
+        usage(name);
+        return EXIT_FAILURE;
+    }
+    
+    if(prefix != NULL && container_name != NULL){
+        fprintf(stderr, "Graphs can be split to files or to a container, but not both -- exiting!\n");
+        usage(name);
+        return EXIT_FAILURE;
     }
     
     if(filter && !(allow_equal || allow_greater || allow_less)){
@@ -302,52 +1257,91 @@ int main(int argc, char** argv) {
         return EXIT_FAILURE;
     }
     
-    int value, min, max, min_count, max_count, min_graph, max_graph;
+    int i, j;
     
-    boolean first = TRUE;
+    //the split files get the extension of the format they are written in
+    char *extension = write_graph == write_digraph6_format ||
+            (write_graph == write_input_graph && read_graph == read_graph_from_digraph6_file) ?
+            "d6" : "wcf";
+    if(split_to_files){
+        start_split(prefix, extension, write_graph);
+    }
+    
+    //the graphs are encoded while they are read if they can be written
+    boolean keep_code = filter || split_to_files || expression_text != NULL;
+    boolean output_header_written = FALSE;
+    
+    start_workers(expression_text, selected, give_overview || summary_file != NULL);
+    summary = &(workers[0].summary);
 
-    while (read_graph(stdin, graph, out, in)) {
-        graph_count++;
-        value = invariant(graph, out, in);
-        if(first){
-            first = FALSE;
-            min = max = value;
-            min_count = max_count = 1;
-            min_graph = max_graph = graph_count;
-        } else {
-            if(min > value){
-                min = value;
-                min_count = 1;
-                min_graph = graph_count;
-            } else if(min == value){
-                min_count++;
-            }
-            if(max < value){
-                max = value;
-                max_count = 1;
-                max_graph = graph_count;
-            } else if(max == value){
-                max_count++;
+    start_phase(PHASE_DECODE);
+    while (TRUE) {
+        batch_size = 0;
+        batch_code_length = 0;
+        while(batch_size < BATCH_SIZE &&
+                read_graph(stdin, batch[batch_size].graph, batch[batch_size].out, batch[batch_size].in)){
+            batch[batch_size].number = input_graph_number();
+            if(keep_code){
+                store_batch_code(batch + batch_size, write_graph);
             }
+            batch_size++;
         }
-        if(verbose){
-            fprintf(stderr, "Graph %d has value %d.\n", graph_count, value);
-        }
-        if(filter){
-            if(allow_equal && filter_value == value){
-                write_watercluster_format(graph, out, stdout);
-                filtered_count++;
-            } else if(allow_less && filter_value > value){
-                write_watercluster_format(graph, out, stdout);
-                filtered_count++;
-            } else if(allow_greater && filter_value < value){
-                write_watercluster_format(graph, out, stdout);
-                filtered_count++;
-            }
+        stop_phase(PHASE_DECODE);
+        if(batch_size == 0){
+            break;
         }
-        if(give_overview || split_to_files) {
-            overview = add_to_overview(overview, value, split_to_files, prefix, graph, out, in);
+        
+        start_phase(PHASE_SEARCH);
+        process_batch();
+        stop_phase(PHASE_SEARCH);
+        
+        start_phase(PHASE_ENCODE);
+        for(j = 0; j < batch_size; j++){
+            BATCH_ENTRY *entry = batch + j;
+            graph_count++;
+            if(!entry->selected){
+                continue;
+            }
+            boolean write_to_output = expression_text != NULL || (filter &&
+                    ((allow_equal && filter_value == entry->values[0]) ||
+                    (allow_less && filter_value > entry->values[0]) ||
+                    (allow_greater && filter_value < entry->values[0])));
+            if(write_to_output){
+                if(!output_header_written){
+                    unsigned char header[MAXHEADERLENGTH];
+                    size_t header_length = encode_graph_header(write_graph, header);
+                    if(header_length){
+                        write_graph_code(header, header_length, stdout);
+                    }
+                    output_header_written = TRUE;
+                }
+                write_graph_code(batch_code + entry->code_start, entry->code_length, stdout);
+                if(filter){
+                    filtered_count++;
+                }
+            }
+            if(verbose && invariant_count == 1){
+                fprintf(stderr, "Graph %llu has value %d.\n", entry->number, entry->values[0]);
+            } else if(verbose && invariant_count > 1){
+                fprintf(stderr, "Graph %llu has values (", entry->number);
+                for(i = 0; i < invariant_count; i++){
+                    fprintf(stderr, "%s%d", i ? ", " : "", entry->values[i]);
+                }
+                fprintf(stderr, ").\n");
+            }
+            if(split_to_files){
+                split_graph(entry->values, batch_code + entry->code_start, entry->code_length);
+            }
         }
+        stop_phase(PHASE_ENCODE);
+        start_phase(PHASE_DECODE);
+    }
+    
+    stop_workers();
+    summary->read_count = graph_count;
+    sort_overview(&(summary->overview));
+    if(split_to_files){
+        finish_split();
     }
     
     int filter_descriptor = (allow_equal ? 1 : 0) +
@@ -363,32 +1357,35 @@ int main(int argc, char** argv) {
     filter_descriptions[6] = " different from";
     filter_descriptions[7] = "ILLEGAL FILTER"; //pass all
     
-    fprintf(stderr, "Read %d graph%s.\n", graph_count, graph_count==1 ? "" : "s");
+    fprintf(stderr, "Read %llu graph%s.\n", graph_count, graph_count==1 ? "" : "s");
+    if(expression_text != NULL){
+        fprintf(stderr, "Written %llu graph%s for which ", summary->selected_count, summary->selected_count==1 ? "" : "s");
+        print_expression(stderr, workers[0].expression);
+    }
     if(filtered_count){
-        fprintf(stderr, "Written %d graph%s with value%s %d.\n", 
+        fprintf(stderr, "Written %llu graph%s with value%s %d.\n", 
                 filtered_count, filtered_count==1 ? "" : "s",
                 filter_descriptions[filter_descriptor],
                 filter_value);
     }
-    if(graph_count){
-        fprintf(stderr, "Minimum: %d\nMaximum: %d\n", min, max);
-        fprintf(stderr, "%d graph%s the minimum and %s is graph %d.\n",
-                min_count, min_count==1 ? " has" : "s have",
-                min_count==1 ? "this" : "the first of these",
-                min_graph);
-        fprintf(stderr, "%d graph%s the maximum and %s is graph %d.\n",
-                max_count, max_count==1 ? " has" : "s have",
-                max_count==1 ? "this" : "the first of these",
-                max_graph);
-    
-        if(overview!=NULL){
-            if(give_overview) {
-                print_overview(overview, stderr);
-            }
-            free_overview_tree(overview);
+    if(summary->selected_count){
+        print_summary(summary, stderr);
+    
+        if(give_overview) {
+            print_overview(&(summary->overview), stderr);
         }
     }
+    if(summary_file != NULL){
+        save_summary(summary, expression_text, summary_file);
+    }
+#ifdef COUNT_SEARCH_NODES
+    fprintf(stderr, "Search nodes: %llu\n", total_search_nodes());
+#endif
+
+    free_overview(&(summary->overview));
+    free_expression(workers[0].expression);
+    free(workers);
+    free(batch_code);
 
     return (EXIT_SUCCESS);
 }
-
@@ -0,0 +1,356 @@
+/*
+ *
+ * Copyright (C) 2026 Ghent University.
+ */
+
+/* This program reads directed graphs in watercluster or digraph6 format from
+ * standard in and looks for copies of one or more small pattern digraphs in
+ * them, e.g.
+ *
+ *     directed_pattern -f -i -p z6 -p '1>2>3>4>1 1>3'
+ *
+ * keeps the graphs that contain neither of the two configurations.
+ *
+ *
+ * Compile with:
+ *
+ *     cc -o directed_pattern -O4 directed_pattern.c
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "../shared/directed_base.h"
+#include "../shared/directed_io.h"
+#include "../shared/directed_stats.h"
+#include "../shared/directed_pattern.h"
+
+#define MAX_PATTERNS 64
+
+unsigned long long int graph_count = 0;
+unsigned long long int filtered_count = 0;
+
+PATTERN *patterns[MAX_PATTERNS];
+int pattern_count = 0;
+
+unsigned long long int graphs_with_pattern[MAX_PATTERNS];
+unsigned long long int copy_total[MAX_PATTERNS];
+
+void add_pattern(const char *text){
+    if(pattern_count == MAX_PATTERNS){
+        fprintf(stderr, "At most %d patterns can be used -- exiting!\n", MAX_PATTERNS);
+        exit(EXIT_FAILURE);
+    }
+    patterns[pattern_count++] = parse_pattern(text);
+}
+
+/**
+ * Adds a pattern for each line of the file. Empty lines and lines starting
+ * with # are skipped.
+ */
+void read_pattern_file(const char *file_name){
+    char line[1024];
+    FILE *f = fopen(file_name, "r");
+    if(f == NULL){
+        fprintf(stderr, "Could not open %s -- exiting!\n", file_name);
+        exit(EXIT_FAILURE);
+    }
+    while(fgets(line, sizeof(line), f) != NULL){
+        char *start = line;
+        char *end = line + strlen(line);
+        while(isspace((unsigned char) *start)) start++;
+        while(end > start && isspace((unsigned char) end[-1])) end--;
+        *end = '\0';
+        if(*start && *start != '#'){
+            add_pattern(start);
+        }
+    }
+    fclose(f);
+}
+
+void print_copy(PATTERN *pattern, const int image[], void *data){
+    int v;
+    fprintf(stdout, "%s:", pattern_name(pattern));
+    for(v = 1; v <= pattern_order(pattern); v++){
+        fprintf(stdout, " %d", image[v]);
+    }
+    fprintf(stdout, "\n");
+}
+
+//====================== USAGE =======================
+
+void help(char *name) {
+    fprintf(stderr, "Looks for copies of small pattern digraphs in directed graphs.\n\n");
+    fprintf(stderr, "Usage\n=====\n");
+    fprintf(stderr, " %s [options] -p pattern [-p pattern ...]\n\n", name);
+    fprintf(stderr, "A pattern is a list of arcs separated by spaces or commas, e.g. 1>2 2>3 3>1\n");
+    fprintf(stderr, "for a directed 3-cycle. The vertices are numbered from 1 up to %d, a>b>c is\n", MAXPATTERN);
+    fprintf(stderr, "short for a>b b>c, and a prefix n: sets the number of vertices if there are\n");
+    fprintf(stderr, "isolated vertices. The names 2cycle, 3cycle and z6 can be used as patterns.\n\n");
+    fprintf(stderr, "By default it is printed for each graph and each pattern whether the graph\n");
+    fprintf(stderr, "contains a copy of the pattern.\n");
+    fprintf(stderr, "\nThis program can handle graphs up to %d vertices. Recompile with a larger\n", MAXN);
+    fprintf(stderr, "value for MAXN if you need to handle larger graphs.\n\n");
+    fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -p pattern, --pattern pattern\n");
+    fprintf(stderr, "       Look for copies of the pattern. This option can be repeated.\n");
+    fprintf(stderr, "    -P file, --pattern-file file\n");
+    fprintf(stderr, "       Look for copies of each pattern in the file (one per line, lines\n");
+    fprintf(stderr, "       starting with # are skipped).\n");
+    fprintf(stderr, "    -I, --induced\n");
+    fprintf(stderr, "       Only look for induced copies, i.e., copies that have no other arcs\n");
+    fprintf(stderr, "       than those of the pattern.\n");
+    fprintf(stderr, "    -4, --quartic\n");
+    fprintf(stderr, "       Only look for copies with all indegrees and outdegrees equal to 2.\n");
+    fprintf(stderr, "    -N, --non-quartic\n");
+    fprintf(stderr, "       Only look for copies with at least one indegree or outdegree larger than 2.\n");
+    fprintf(stderr, "    -c, --count\n");
+    fprintf(stderr, "       Count the copies of each pattern in each graph.\n");
+    fprintf(stderr, "    -a, --all\n");
+    fprintf(stderr, "       Print each copy of each pattern as the images of the vertices of the\n");
+    fprintf(stderr, "       pattern.\n");
+    fprintf(stderr, "    -f, --filter\n");
+    fprintf(stderr, "       Filter graphs that contain a copy of at least one of the patterns.\n");
+    fprintf(stderr, "    -i, --invert\n");
+    fprintf(stderr, "       Invert the filter.\n");
+    fprintf(stderr, "    -u n, --update n\n");
+    fprintf(stderr, "       Give an update every n graphs.\n");
+    fprintf(stderr, "    -D, --digraph6\n");
+    fprintf(stderr, "       Reads graphs in digraph6 format instead of watercluster format.\n");
+    fprintf(stderr, "    -O format, --output-format format\n");
+    fprintf(stderr, "       Writes graphs in the given format: wcf (watercluster), d6 (digraph6),\n");
+    fprintf(stderr, "       bits (bitset container), adj (adjacency lists) or multi (multi_code).\n");
+    fprintf(stderr, "       By default, or with input, the graphs are copied unchanged from the\n");
+    fprintf(stderr, "       input.\n");
+    help_shared_io_options(stderr);
+    fprintf(stderr, "    -h, --help\n");
+    fprintf(stderr, "       Print this help and return.\n");
+}
+
+void usage(char *name) {
+    fprintf(stderr, "Usage: %s [options] -p pattern [-p pattern ...]\n", name);
+    fprintf(stderr, "For more information type: %s -h \n\n", name);
+}
+
+/*
+ *
+ */
+int main(int argc, char** argv) {
+
+    GRAPH graph;
+    DEGREES out;
+    DEGREES in;
+
+    boolean do_filtering = FALSE;
+    boolean invert = FALSE;
+    boolean count = FALSE;
+    boolean all = FALSE;
+    boolean induced = FALSE;
+    boolean quartic = FALSE;
+    boolean non_quartic = FALSE;
+
+    boolean (*read_graph)(FILE *, GRAPH, DEGREES, DEGREES) = read_graph_from_watercluster_file;
+    void (*write_graph)(GRAPH, DEGREES, FILE *) = write_input_graph;
+
+    int update = 0;
+
+    /*=========== commandline parsing ===========*/
+
+    int c;
+    char *name = argv[0];
+    static struct option long_options[] = {
+        {"pattern", required_argument, NULL, 'p'},
+        {"pattern-file", required_argument, NULL, 'P'},
+        {"induced", no_argument, NULL, 'I'},
+        {"quartic", no_argument, NULL, '4'},
+        {"non-quartic", no_argument, NULL, 'N'},
+        {"count", no_argument, NULL, 'c'},
+        {"all", no_argument, NULL, 'a'},
+        {"filter", no_argument, NULL, 'f'},
+        {"invert", no_argument, NULL, 'i'},
+        {"update", required_argument, NULL, 'u'},
+        {"digraph6", no_argument, NULL, 'D'},
+        {"output-format", required_argument, NULL, 'O'},
+        {"help", no_argument, NULL, 'h'},
+        SHARED_IO_OPTIONS,
+        {NULL, 0, NULL, 0}
+    };
+    int option_index = 0;
+
+    while ((c = getopt_long(argc, argv, "hp:P:I4Ncafiu:DO:", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 'p':
+                add_pattern(optarg);
+                break;
+            case 'P':
+                read_pattern_file(optarg);
+                break;
+            case 'I':
+                induced = TRUE;
+                break;
+            case '4':
+                quartic = TRUE;
+                break;
+            case 'N':
+                non_quartic = TRUE;
+                break;
+            case 'c':
+                count = TRUE;
+                break;
+            case 'a':
+                all = TRUE;
+                break;
+            case 'f':
+                do_filtering = TRUE;
+                break;
+            case 'i':
+                invert = TRUE;
+                break;
+            case 'u':
+                update = atoi(optarg);
+                break;
+            case 'D':
+                read_graph = read_graph_from_digraph6_file;
+                break;
+            case 'O':
+                write_graph = input_writer_for_format(optarg);
+                if(write_graph == NULL){
+                    fprintf(stderr, "Unknown output format: %s -- exiting!\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case SELECT_RANGE_OPTION:
+            case SELECT_IDS_OPTION:
+            case SELECT_INDEX_OPTION:
+            case COMPRESS_OPTION:
+            case COMPRESS_THREADS_OPTION:
+                handle_shared_io_option(c, optarg);
+                break;
+            case 'h':
+                help(name);
+                return EXIT_SUCCESS;
+            case '?':
+                usage(name);
+                return EXIT_FAILURE;
+            default:
+                fprintf(stderr, "Illegal option %c.\n", c);
+                usage(name);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if(pattern_count == 0){
+        fprintf(stderr, "Please specify at least one pattern -- exiting!\n");
+        usage(name);
+        return EXIT_FAILURE;
+    }
+    if(!do_filtering && update){
+        fprintf(stderr, "Updates are only available when filtering is enabled.\n");
+        update = 0;
+    }
+    if(quartic && non_quartic){
+        fprintf(stderr, "Quartic and non-quartic cannot be combined -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    if(count && all){
+        fprintf(stderr, "Counting and listing all copies cannot be combined -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    if(do_filtering && all){
+        fprintf(stderr, "Filtering and listing all copies cannot be combined -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    int flags = (induced ? PATTERN_INDUCED : 0) |
+            (quartic ? PATTERN_QUARTIC : 0) | (non_quartic ? PATTERN_NON_QUARTIC : 0);
+
+    int i;
+    start_phase(PHASE_DECODE);
+    while (read_graph(stdin, graph, out, in)) {
+        stop_phase(PHASE_DECODE);
+        graph_count++;
+
+        if(all){
+            fprintf(stdout, "Graph %llu:\n", input_graph_number());
+        }
+        boolean value = FALSE;
+        for(i = 0; i < pattern_count; i++){
+            unsigned long long int copies;
+            start_phase(PHASE_SEARCH);
+            if(all){
+                copies = find_pattern(patterns[i], graph, out, in, flags, print_copy, NULL);
+            } else if(count){
+                copies = count_pattern(patterns[i], graph, out, in, flags);
+            } else {
+                copies = has_pattern(patterns[i], graph, out, in, flags);
+            }
+            stop_phase(PHASE_SEARCH);
+            copy_total[i] += copies;
+            if(copies){
+                graphs_with_pattern[i]++;
+                value = TRUE;
+            }
+            if(do_filtering){
+                //one pattern is enough to decide the filter
+                if(value && !count) break;
+            } else if(count){
+                fprintf(stdout, "Graph %llu has %llu cop%s of %s.\n", input_graph_number(),
+                        copies, copies==1 ? "y" : "ies", pattern_name(patterns[i]));
+            } else if(!all){
+                fprintf(stdout, "Graph %llu %s a copy of %s.\n", input_graph_number(),
+                        copies ? "has" : "does not have", pattern_name(patterns[i]));
+            }
+        }
+        if(all){
+            fprintf(stdout, "\n");
+        }
+        if(do_filtering){
+            if((invert && !value) || (!invert && value)){
+                filtered_count++;
+                start_phase(PHASE_ENCODE);
+                write_graph(graph, out, stdout);
+                stop_phase(PHASE_ENCODE);
+            }
+            if(update && !(graph_count % update)){
+                fprintf(stderr, "Read: %llu. Filtered: %llu\n", graph_count, filtered_count);
+            }
+        }
+        start_phase(PHASE_DECODE);
+    }
+    stop_phase(PHASE_DECODE);
+
+    fprintf(stderr, "Read %llu graph%s.\n", graph_count, graph_count==1 ? "" : "s");
+    for(i = 0; i < pattern_count; i++){
+        if(count || all){
+            fprintf(stderr, "Found %llu cop%s of %s.\n", copy_total[i], copy_total[i]==1 ? "y" : "ies",
+                    pattern_name(patterns[i]));
+        } else if(!do_filtering){
+            fprintf(stderr, "Found %s in %llu graph%s.\n", pattern_name(patterns[i]),
+                    graphs_with_pattern[i], graphs_with_pattern[i]==1 ? "" : "s");
+        }
+    }
+    if(do_filtering){
+        fprintf(stderr, "Filtered %llu graph%s that %scontain a copy of %s.\n", filtered_count,
+                filtered_count==1 ? "" : "s", invert ? "do not " : "", pattern_count==1 ? "the pattern" : "a pattern");
+        if(induced){
+            fprintf(stderr, "Only induced copies where taken into account.\n");
+        }
+        if(quartic){
+            fprintf(stderr, "Only quartic copies where taken into account.\n");
+        }
+        if(non_quartic){
+            fprintf(stderr, "Only non-quartic copies where taken into account.\n");
+        }
+    }
+
+    for(i = 0; i < pattern_count; i++){
+        free_pattern(patterns[i]);
+    }
+
+    return (EXIT_SUCCESS);
+}
+
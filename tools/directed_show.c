@@ -19,6 +19,7 @@
 
 #include "../shared/directed_base.h"
 #include "../shared/directed_io.h"
+#include "../shared/directed_stats.h"
 
 unsigned long long int graph_count = 0;
 
@@ -33,6 +34,7 @@ void help(char *name) {
     fprintf(stderr, "Valid options\n=============\n");
     fprintf(stderr, "    -D, --digraph6\n");
     fprintf(stderr, "       Reads graphs in digraph6 format instead of watercluster format.\n");
+    help_shared_io_options(stderr);
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
@@ -59,7 +61,9 @@ int main(int argc, char** argv) {
     char *name = argv[0];
     static struct option long_options[] = {
         {"digraph6", no_argument, NULL, 'D'},
-        {"help", no_argument, NULL, 'h'}
+        {"help", no_argument, NULL, 'h'},
+        SHARED_IO_OPTIONS,
+        {NULL, 0, NULL, 0}
     };
     int option_index = 0;
 
@@ -68,6 +72,13 @@ int main(int argc, char** argv) {
             case 'D':
                 read_graph = read_graph_from_digraph6_file;
                 break;
+            case SELECT_RANGE_OPTION:
+            case SELECT_IDS_OPTION:
+            case SELECT_INDEX_OPTION:
+            case COMPRESS_OPTION:
+            case COMPRESS_THREADS_OPTION:
+                handle_shared_io_option(c, optarg);
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -81,9 +92,12 @@ int main(int argc, char** argv) {
         }
     }
 
+    start_phase(PHASE_DECODE);
     while (read_graph(stdin, graph, out, in)) {
+        stop_phase(PHASE_DECODE);
         graph_count++;
-        fprintf(stdout, "Graph %llu:\n", graph_count);
+        start_phase(PHASE_ENCODE);
+        fprintf(stdout, "Graph %llu:\n", input_graph_number());
         int order = graph[0][0];
         int v, i;
         for(v = 1; v <= order; v++){
@@ -97,7 +111,10 @@ int main(int argc, char** argv) {
             fprintf(stdout, "\n");
         }
         fprintf(stdout, "\n");
+        stop_phase(PHASE_ENCODE);
+        start_phase(PHASE_DECODE);
     }
+    stop_phase(PHASE_DECODE);
     
     fprintf(stderr, "Read %llu graph%s.\n", graph_count, graph_count==1 ? "" : "s");
 
@@ -2,28 +2,68 @@
 
 import math
 
-def read_waterclusterfile(code_input):
+def read_waterclusterfile(code_input, block_size=1 << 20):
+    # the input is read in large blocks instead of byte per byte
+    data = b''
+    position = 0
     while True:
-        c = code_input.read(1)
-        if len(c)==0:
-            return
-
-        order = ord(c)
-
-        zeroCount = 0
+        if position == len(data):
+            data = code_input.read(block_size)
+            position = 0
+            if len(data) == 0:
+                return
 
+        order = data[position]
         g = [([],[]) for i in range(order)]
-
+        zeroCount = 0
+        i = position + 1
         while zeroCount < order:
-            c = code_input.read(1)
-            if ord(c) == 0:
+            if i == len(data):
+                # the code continues in the next block: decode it again
+                block = code_input.read(block_size)
+                if len(block) == 0:
+                    raise ValueError('Incomplete watercluster code')
+                data = data[position:] + block
+                position = 0
+                g = [([],[]) for j in range(order)]
+                zeroCount = 0
+                i = 1
+                continue
+            c = data[i]
+            i += 1
+            if c == 0:
                 zeroCount += 1
             else:
-                g[zeroCount][0].append(ord(c)-1)
-                g[ord(c)-1][1].append(zeroCount)
+                g[zeroCount][0].append(c-1)
+                g[c-1][1].append(zeroCount)
+        position = i
 
         yield(g)
 
+def read_adjacency_lists(text_input):
+    # the text format of directed_convert -o adj: a line 'v: w1, w2, ...' for
+    # each vertex and an empty line after each graph
+    arcs = []
+    for line in text_input:
+        line = line.strip()
+        if not line:
+            if arcs:
+                yield(adjacency_lists_to_graph(arcs))
+                arcs = []
+            continue
+        vertex, neighbours = line.split(':', 1)
+        arcs.append((int(vertex), [int(w) for w in neighbours.split(',') if w.strip()]))
+    if arcs:
+        yield(adjacency_lists_to_graph(arcs))
+
+def adjacency_lists_to_graph(arcs):
+    g = [([],[]) for i in range(len(arcs))]
+    for v, neighbours in arcs:
+        for w in neighbours:
+            g[v-1][0].append(w-1)
+            g[w-1][1].append(v-1)
+    return g
+
 def cartesian_to_polar(coord):
     x, y = coord
     return math.hypot(x,y),math.degrees(math.atan2(y,x))
@@ -89,9 +129,12 @@ if __name__ == '__main__':
     import sys
     import os.path
 
-    parser = argparse.ArgumentParser(description='Creates image in TikZ format for directed graph in watercluster format.')
+    parser = argparse.ArgumentParser(description='Creates image in TikZ format for directed graph in watercluster format.',
+                    epilog='Other formats can be piped through directed_convert, e.g. '
+                    '"directed_convert -i d6 -o adj < graphs.d6 | wcf2tikz.py -a".')
+    parser.set_defaults(embed_method=circular_embedding)
     if (not os.path.isfile('./gconv')) or (not os.path.isfile('./embed')) or (not os.path.isfile('./planarg')):
-        print('Missing the tools to handle planar embeddings. The -p option is not available.')
+        print('Missing the tools to handle planar embeddings. The -p option is not available.', file=sys.stderr)
     else:
         parser.add_argument('-p', '--planar', dest='embed_method', action='store_const',
                     const=planar_embedding, default=circular_embedding,
@@ -99,8 +142,12 @@ if __name__ == '__main__':
     parser.add_argument('-P', '--polar', dest='node_printer', action='store_const',
                     const=print_node_polar, default=print_node,
                     help='Use polar coordinates')
+    parser.add_argument('-a', '--adj', dest='reader', action='store_const',
+                    const=lambda: read_adjacency_lists(sys.stdin),
+                    default=lambda: read_waterclusterfile(sys.stdin.buffer),
+                    help='Read the adjacency lists written by directed_convert -o adj')
 
     args = parser.parse_args()
 
-    for g in read_waterclusterfile(sys.stdin):
+    for g in args.reader():
         graph_to_tikz(g, args.embed_method, args.node_printer)